@@ -520,16 +520,175 @@ void LogsDialog::on_fileOpen_BT_clicked()
   }
 }
 
+// Binary logs written by the radio when built with BINARY_LOGS=YES, see radio/src/logs.cpp
+#define LOGS_MAGIC          "OTXL"
+#define LOGS_VERSION        1
+#define LOGS_RECORD         'R'
+
+enum LogsColumnFormat {
+  LOGS_COLUMN_VALUE,
+  LOGS_COLUMN_DATE,
+  LOGS_COLUMN_TIME,
+  LOGS_COLUMN_GPS,
+  LOGS_COLUMN_DATETIME,
+};
+
+struct LogsColumn {
+  int format;
+  int prec;
+};
+
+static bool readLogsVarint(const QByteArray & data, int & offset, quint32 & result)
+{
+  result = 0;
+  for (int shift=0; offset<data.size() && shift<35; shift+=7) {
+    quint8 byte = data.at(offset++);
+    result |= (quint32)(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+
+static QString readLogsString(const QByteArray & data, int & offset)
+{
+  int end = data.indexOf('\0', offset);
+  if (end < 0)
+    end = data.size();
+  QString result = QString::fromLatin1(data.mid(offset, end-offset));
+  offset = end + 1;
+  return result;
+}
+
+static QString formatLogsGps(qint32 value, char positive, char negative)
+{
+  qint32 position = qAbs(value) - 1;
+  return QString().sprintf("%03d.%04d%c", position/10000, position%10000, value < 0 ? negative : positive);
+}
+
+// the same text as in the CSV logs
+static QString formatLogsValue(const LogsColumn & column, const qint32 * values)
+{
+  switch (column.format) {
+    case LOGS_COLUMN_DATE:
+      return QString().sprintf("%4d-%02d-%02d", values[0]/10000, values[0]/100%100, values[0]%100);
+    case LOGS_COLUMN_TIME:
+      return QString().sprintf("%02d:%02d:%02d.%02d0", values[0]/360000, values[0]/6000%60, values[0]/100%60, values[0]%100);
+    case LOGS_COLUMN_GPS:
+      if (!values[0] || !values[1])
+        return QString();
+      return formatLogsGps(values[0], 'E', 'W') + " " + formatLogsGps(values[1], 'N', 'S');
+    case LOGS_COLUMN_DATETIME:
+      if (!values[0])
+        return QString();
+      return QString().sprintf("%4d-%02d-%02d %02d:%02d:%02d", values[0]/10000, values[0]/100%100, values[0]%100, values[1]/10000, values[1]/100%100, values[1]%100);
+    default:
+      if (column.prec == 2)
+        return QString().sprintf("%s%d.%02d", values[0] < 0 ? "-" : "", qAbs(values[0])/100, qAbs(values[0])%100);
+      else if (column.prec == 1)
+        return QString().sprintf("%s%d.%d", values[0] < 0 ? "-" : "", qAbs(values[0])/10, qAbs(values[0])%10);
+      else
+        return QString::number(values[0]);
+  }
+}
+
+// fills csvlog as if the logs were in CSV, returns the number of invalid records
+int LogsDialog::binFileParse(const QByteArray & data)
+{
+  QList<LogsColumn> columns;
+  QVector<qint32> values;
+  int errors = 0;
+  int offset = 0;
+  bool skip = false;
+
+  while (offset < data.size()) {
+    if (data.at(offset) != LOGS_RECORD) {
+      // a header, written each time the radio opens the file
+      if (data.mid(offset, sizeof(LOGS_MAGIC)-1) != LOGS_MAGIC || offset+(int)sizeof(LOGS_MAGIC)+1 > data.size() || data.at(offset+sizeof(LOGS_MAGIC)-1) != LOGS_VERSION) {
+        errors++;
+        break;
+      }
+      offset += sizeof(LOGS_MAGIC); // the magic and the version
+      int count = (quint8)data.at(offset++);
+      QStringList titles;
+      columns.clear();
+      int size = 0;
+      for (int i=0; i<count && offset<data.size(); i++) {
+        LogsColumn column;
+        column.format = (quint8)data.at(offset++);
+        column.prec = (offset < data.size() ? (quint8)data.at(offset++) : 0);
+        QString name = readLogsString(data, offset);
+        QString unit = readLogsString(data, offset);
+        titles.append(unit.isEmpty() ? name : QString("%1(%2)").arg(name).arg(unit));
+        columns.append(column);
+        size += (column.format == LOGS_COLUMN_GPS || column.format == LOGS_COLUMN_DATETIME) ? 2 : 1;
+      }
+      values.fill(0, size);
+      if (csvlog.isEmpty()) {
+        if (titles.isEmpty() || titles.first() != "Date") {
+          errors++;
+          break;
+        }
+        csvlog.append(titles);
+      }
+      // the records don't fit the columns shown if the sensors changed meanwhile
+      skip = (titles != csvlog.at(0));
+      continue;
+    }
+
+    if (csvlog.isEmpty()) {
+      errors++;
+      break;
+    }
+
+    offset++;
+    bool valid = true;
+    for (int i=0; i<values.size() && valid; i++) {
+      quint32 zigzag;
+      valid = readLogsVarint(data, offset, zigzag);
+      values[i] = (qint32)((quint32)values[i] + ((zigzag >> 1) ^ (0u - (zigzag & 1))));
+    }
+    if (!valid || skip) {
+      errors++;
+      continue;
+    }
+
+    QStringList record;
+    const qint32 * value = values.constData();
+    foreach (const LogsColumn & column, columns) {
+      record.append(formatLogsValue(column, value));
+      value += (column.format == LOGS_COLUMN_GPS || column.format == LOGS_COLUMN_DATETIME) ? 2 : 1;
+    }
+    csvlog.append(record);
+  }
+
+  return errors;
+}
+
 bool LogsDialog::cvsFileParse()
 {
   QFile file(ui->FileName_LE->text());
   int errors=0;
   int lines=-1;
 
-  if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) { // reading HEX TEXT file
+  if (!file.open(QIODevice::ReadOnly)) {
     return false;
   }
+  else if (file.peek(sizeof(LOGS_MAGIC)-1) == LOGS_MAGIC) {
+    csvlog.clear();
+    logFilename.clear();
+    errors = binFileParse(file.readAll());
+    if (csvlog.isEmpty()) {
+      return false;
+    }
+    lines = csvlog.count() + errors - 1;
+    logFilename = QFileInfo(file.fileName()).baseName();
+  }
   else {
+    file.close();
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) { // reading HEX TEXT file
+      return false;
+    }
     csvlog.clear();
     logFilename.clear();
     QTextStream inputStream(&file);
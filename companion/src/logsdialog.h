@@ -82,6 +82,7 @@ private:
   minMax yAxesRanges[AXES_LIMIT];
 
   bool cvsFileParse();
+  int binFileParse(const QByteArray & data);
   QList<QStringList> filterGePoints(const QList<QStringList> & input);
   void exportToGoogleEarth();
   QDateTime getRecordTimeStamp(int index);
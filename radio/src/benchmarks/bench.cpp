@@ -0,0 +1,251 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+// Host-side benchmark of the mixer hot path
+//
+//   make PCB=TARANIS bench
+//   ./bench [-c cycles] [eeprom images...]
+//
+// Without eeprom images the built-in models (see models.cpp) are measured. Each model is driven
+// with the same stick sweeps, and the results are printed on stdout as CSV lines:
+//   model,stage,calls,ns
+
+#include <time.h>
+#include <unistd.h>
+#include "bench.h"
+
+uint16_t anaInValues[NUM_STICKS+NUM_POTS] = { 0 };
+uint16_t anaIn(uint8_t chan)
+{
+  if (chan < NUM_STICKS+NUM_POTS)
+    return anaInValues[chan];
+  else
+    return 0;
+}
+
+extern uint8_t s_mixer_first_run_done;
+
+static volatile int32_t benchSink; // keeps the compiler from dropping the measured calls
+static FILE * benchOutput;
+
+// the getValue() stages, one per source family
+static const struct {
+  const char * stage;
+  mixsrc_t first;
+  mixsrc_t last;
+} benchSourceFamilies[] = {
+#if defined(VIRTUALINPUTS)
+  { "getValue(inputs)", MIXSRC_FIRST_INPUT, MIXSRC_LAST_INPUT },
+#endif
+  { "getValue(sticks)", MIXSRC_FIRST_STICK, MIXSRC_LAST_POT },
+  { "getValue(trims)", MIXSRC_FIRST_TRIM, MIXSRC_LAST_TRIM },
+  { "getValue(switches)", MIXSRC_FIRST_SWITCH, MIXSRC_LAST_SWITCH },
+  { "getValue(logical switches)", MIXSRC_FIRST_LOGICAL_SWITCH, MIXSRC_LAST_LOGICAL_SWITCH },
+  { "getValue(trainer)", MIXSRC_FIRST_TRAINER, MIXSRC_LAST_TRAINER },
+  { "getValue(channels)", MIXSRC_FIRST_CH, MIXSRC_LAST_CH },
+  { "getValue(gvars)", MIXSRC_FIRST_GVAR, MIXSRC_LAST_GVAR },
+  { "getValue(timers)", MIXSRC_FIRST_TIMER, MIXSRC_LAST_TIMER },
+  { "getValue(telemetry)", MIXSRC_FIRST_TELEM, MIXSRC_LAST_TELEM },
+};
+
+static uint64_t getNanoseconds()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// each analog is a triangle between both ends, with its own period so that the inputs don't move together
+static void setSticks(int cycle)
+{
+  for (int i=0; i<NUM_STICKS+NUM_POTS; i++) {
+    int half = 100 + 17*i;
+    int phase = cycle % (2*half);
+    anaInValues[i] = (phase < half ? phase : 2*half-phase) * 2*BENCH_ADC_MID / half;
+  }
+}
+
+static void calibrateSticks()
+{
+  for (int i=0; i<NUM_STICKS+NUM_POTS; i++) {
+    g_eeGeneral.calib[i].mid = BENCH_ADC_MID;
+    g_eeGeneral.calib[i].spanNeg = BENCH_ADC_MID;
+    g_eeGeneral.calib[i].spanPos = BENCH_ADC_MID;
+  }
+}
+
+void benchModelReady()
+{
+  s_mixer_first_run_done = false;
+  lastFlightMode = 255;
+  INVALIDATE_MIXER_PROGRAM();
+  logicalSwitchesReset();
+#if defined(XCURVES)
+  loadCurves();
+#endif
+}
+
+static void report(const char * model, const char * stage, uint32_t calls, uint64_t duration)
+{
+  fprintf(benchOutput, "%s,%s,%u,%.1f\n", model, stage, calls, (double)duration / calls);
+}
+
+static void benchModel(const char * model, int cycles)
+{
+  uint64_t start;
+
+  // a 10ms tick on each cycle, so that the logical switches and the functions are always evaluated
+  for (int i=0; i<BENCH_WARMUP_CYCLES; i++) {
+    setSticks(i);
+    g_tmr10ms++;
+    doMixerCalculations();
+  }
+
+  start = getNanoseconds();
+  for (int i=0; i<cycles; i++) {
+    setSticks(i);
+    g_tmr10ms++;
+    doMixerCalculations();
+  }
+  report(model, "cycle", cycles, getNanoseconds() - start);
+
+  start = getNanoseconds();
+  for (int i=0; i<cycles; i++) {
+    setSticks(i);
+    evalMixes(1);
+  }
+  report(model, "evalMixes", cycles, getNanoseconds() - start);
+
+  start = getNanoseconds();
+  for (int i=0; i<cycles; i++) {
+    setSticks(i);
+    evalInputs(e_perout_mode_normal);
+    evalLogicalSwitches(true);
+  }
+  uint64_t duration = getNanoseconds() - start;
+  // the inputs have to move for the logical switches to be evaluated, their own duration is deducted
+  start = getNanoseconds();
+  for (int i=0; i<cycles; i++) {
+    setSticks(i);
+    evalInputs(e_perout_mode_normal);
+  }
+  uint64_t inputsDuration = getNanoseconds() - start;
+  report(model, "evalLogicalSwitches", cycles, duration > inputsDuration ? duration - inputsDuration : 0);
+
+  uint32_t calls = 0;
+  int32_t sum = 0;
+  start = getNanoseconds();
+  for (int i=0; i<cycles; i++) {
+    int x = (i * 37) % (2*RESX+1) - RESX;
+    for (int c=0; c<MAX_CURVES; c++) {
+#if defined(XCURVES)
+      CurveRef curve;
+      curve.type = CURVE_REF_CUSTOM;
+      curve.value = c+1;
+      sum += applyCurve(x, curve);
+#else
+      sum += applyCurve(x, CURVE_BASE+c);
+#endif
+      calls++;
+    }
+  }
+  report(model, "applyCurve", calls, getNanoseconds() - start);
+
+  for (unsigned int f=0; f<DIM(benchSourceFamilies); f++) {
+    calls = 0;
+    start = getNanoseconds();
+    for (int i=0; i<cycles; i++) {
+      for (mixsrc_t src=benchSourceFamilies[f].first; src<=benchSourceFamilies[f].last; src++) {
+        sum += getValue(src);
+        calls++;
+      }
+    }
+    report(model, benchSourceFamilies[f].stage, calls, getNanoseconds() - start);
+  }
+
+  benchSink = sum;
+}
+
+int main(int argc, char **argv)
+{
+  int cycles = BENCH_DEFAULT_CYCLES;
+  int first = 1;
+  if (argc > 2 && !strcmp(argv[1], "-c")) {
+    cycles = atoi(argv[2]);
+    first = 3;
+  }
+
+  // the simulator traces go to stdout, they are moved to stderr to keep the results alone on stdout
+  benchOutput = fdopen(dup(STDOUT_FILENO), "w");
+  dup2(STDERR_FILENO, STDOUT_FILENO);
+
+  simuInit();
+  StartEepromThread(NULL);
+
+  fprintf(benchOutput, "model,stage,calls,ns\n");
+
+  if (first == argc) {
+    for (const BenchModel * model=benchModels; model->name; model++) {
+      generalDefault();
+      calibrateSticks();
+      model->setup();
+      benchModelReady();
+      benchModel(model->name, cycles);
+    }
+  }
+
+  for (int i=first; i<argc; i++) {
+    if (!simuLoadEepromImage(argv[i])) {
+      continue;
+    }
+    // the radio calibration stored in the image doesn't match the sweeps
+    calibrateSticks();
+    for (uint8_t id=0; id<MAX_MODELS; id++) {
+      if (eeModelExists(id)) {
+        char name[sizeof(g_model.header.name)+1];
+        char label[256];
+        eeLoadModel(id);
+        zchar2str(name, g_model.header.name, sizeof(g_model.header.name));
+        snprintf(label, sizeof(label), "%s:%d:%s", argv[i], id+1, name);
+        benchModelReady();
+        benchModel(label, cycles);
+      }
+    }
+  }
+
+  fclose(benchOutput);
+  return 0;
+}
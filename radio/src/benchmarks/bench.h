@@ -0,0 +1,62 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#ifndef bench_h
+#define bench_h
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "opentx.h"
+
+#if !defined(CPUARM)
+  #error "The benchmark is only available for the ARM boards"
+#endif
+
+#define BENCH_DEFAULT_CYCLES  20000
+#define BENCH_WARMUP_CYCLES   500
+#define BENCH_ADC_MID         1024   // the sweeps go from 0 to 2*BENCH_ADC_MID
+
+struct BenchModel {
+  const char * name;
+  void (*setup)();
+};
+
+extern const BenchModel benchModels[]; // terminated by a NULL name
+
+extern uint16_t anaInValues[NUM_STICKS+NUM_POTS];
+
+#endif
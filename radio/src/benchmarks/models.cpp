@@ -0,0 +1,298 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+// Built-in models of the benchmark, each one stressing a different part of the mixer
+
+#include "bench.h"
+
+#if defined(PCBTARANIS)
+  #define BENCH_SW_FM1    SWSRC_SA1
+  #define BENCH_SW_FM2    SWSRC_SA2
+  #define BENCH_SW_FM3    SWSRC_SB2
+  #define BENCH_SW_HOLD   SWSRC_SF2
+  #define BENCH_SW_MIX    SWSRC_SC2
+#else
+  #define BENCH_SW_FM1    SWSRC_ID1
+  #define BENCH_SW_FM2    SWSRC_ID2
+  #define BENCH_SW_FM3    SWSRC_GEA
+  #define BENCH_SW_HOLD   SWSRC_THR
+  #define BENCH_SW_MIX    SWSRC_AIL
+#endif
+
+static const int8_t benchCurves[][5] = {
+  { -100, 20, 30, 70, 90 },
+  { 80, 70, 60, 70, 100 },
+  { -30, -15, 0, 50, 100 },
+  { -100, -50, 0, 50, 100 },
+  { 100, 50, 0, 50, 100 },
+  { -100, -80, -20, 40, 100 },
+};
+
+static uint8_t stickSource(uint8_t stick)
+{
+#if defined(VIRTUALINPUTS)
+  return MIXSRC_FIRST_INPUT + stick;
+#else
+  return MIXSRC_Rud + stick;
+#endif
+}
+
+// mixes have to be added in the channels order
+static MixData * addMix(uint8_t ch, uint8_t src, int16_t weight=100, int8_t swtch=SWSRC_NONE)
+{
+  for (uint8_t i=0; i<MAX_MIXERS; i++) {
+    MixData * mix = mixAddress(i);
+    if (!mix->srcRaw) {
+      mix->destCh = ch;
+      mix->srcRaw = src;
+      mix->weight = weight;
+      mix->swtch = swtch;
+      return mix;
+    }
+  }
+  return mixAddress(MAX_MIXERS-1);
+}
+
+static void setMixCurve(MixData * mix, uint8_t idx)
+{
+#if defined(XCURVES)
+  mix->curve.type = CURVE_REF_CUSTOM;
+  mix->curve.value = idx + 1;
+#else
+  mix->curveMode = MODE_CURVE;
+  mix->curveParam = CURVE_BASE + idx;
+#endif
+}
+
+static void setMixDifferential(MixData * mix, int8_t value)
+{
+#if defined(XCURVES)
+  mix->curve.type = CURVE_REF_DIFF;
+  mix->curve.value = value;
+#else
+  mix->curveMode = MODE_DIFFERENTIAL;
+  mix->curveParam = value;
+#endif
+}
+
+// all curves keep their default size of 5 points, so that their points don't move
+static void setCurves(bool smooth)
+{
+  for (uint8_t c=0; c<MAX_CURVES; c++) {
+    const int8_t * points = benchCurves[c % DIM(benchCurves)];
+    for (uint8_t i=0; i<5; i++) {
+      g_model.points[5*c+i] = points[i];
+    }
+#if defined(XCURVES)
+    g_model.curves[c].smooth = smooth;
+#endif
+  }
+}
+
+static void setLogicalSwitch(uint8_t idx, uint8_t func, int16_t v1, int16_t v2, int8_t andsw=SWSRC_NONE)
+{
+  LogicalSwitchData * ls = lswAddress(idx);
+  ls->func = func;
+  ls->v1 = v1;
+  ls->v2 = v2;
+  ls->andsw = andsw;
+}
+
+static void setupDefault()
+{
+  modelDefault(0);
+}
+
+static void setupHeli()
+{
+  modelDefault(0);
+  memclear(g_model.mixData, sizeof(g_model.mixData));
+
+  g_model.flightModeData[1].swtch = BENCH_SW_FM1;
+  g_model.flightModeData[2].swtch = BENCH_SW_FM2;
+  g_model.flightModeData[3].swtch = BENCH_SW_HOLD;
+
+#if defined(HELI)
+  g_model.swashR.type = SWASH_TYPE_120;
+  g_model.swashR.collectiveSource = MIXSRC_CH11;
+#if defined(VIRTUALINPUTS)
+  g_model.swashR.aileronSource = stickSource(AIL_STICK);
+  g_model.swashR.elevatorSource = stickSource(ELE_STICK);
+  g_model.swashR.collectiveWeight = 100;
+  g_model.swashR.aileronWeight = 100;
+  g_model.swashR.elevatorWeight = 100;
+#endif
+#endif
+
+  addMix(0, MIXSRC_CYC1);
+  addMix(1, MIXSRC_CYC2);
+  addMix(2, MIXSRC_CYC3);
+  addMix(3, stickSource(RUD_STICK));
+  // throttle curve per flight mode, throttle hold last
+  for (uint8_t fm=0; fm<3; fm++) {
+    MixData * mix = addMix(4, stickSource(THR_STICK));
+    mix->flightModes = ~(1 << fm);
+    mix->carryTrim = TRIM_OFF;
+    setMixCurve(mix, fm);
+  }
+  MixData * mix = addMix(4, MIXSRC_MAX, -100, BENCH_SW_HOLD);
+  mix->mltpx = MLTPX_REP;
+  // gyro gain
+  addMix(5, MIXSRC_MAX, 30, -BENCH_SW_MIX);
+  addMix(5, MIXSRC_MAX, -30, BENCH_SW_MIX);
+  // collective
+  for (uint8_t fm=0; fm<4; fm++) {
+    mix = addMix(10, stickSource(THR_STICK));
+    mix->flightModes = ~(1 << fm);
+    mix->carryTrim = TRIM_OFF;
+    setMixCurve(mix, 2+fm);
+  }
+
+  setCurves(true);
+}
+
+static void setupGlider()
+{
+  modelDefault(0);
+  memclear(g_model.mixData, sizeof(g_model.mixData));
+
+  // launch, speed, thermal, landing (crow)
+  for (uint8_t fm=1; fm<=3; fm++) {
+    g_model.flightModeData[fm].fadeIn = 10;
+    g_model.flightModeData[fm].fadeOut = 10;
+  }
+  g_model.flightModeData[1].swtch = BENCH_SW_FM1;
+  g_model.flightModeData[2].swtch = BENCH_SW_FM2;
+  g_model.flightModeData[3].swtch = SWSRC_SW2;
+
+  // L1: throttle stick down, L2: L1 and the crow switch
+  setLogicalSwitch(0, LS_FUNC_VNEG, stickSource(THR_STICK), -50);
+  setLogicalSwitch(1, LS_FUNC_AND, SWSRC_SW1, BENCH_SW_FM3);
+  setLogicalSwitch(2, LS_FUNC_APOS, stickSource(AIL_STICK), 80, SWSRC_SW2);
+
+  MixData * mix;
+  // ailerons with differential, flaperons and crow
+  for (uint8_t ch=0; ch<2; ch++) {
+    mix = addMix(ch, stickSource(AIL_STICK), ch==0 ? 100 : -100);
+    setMixDifferential(mix, 30);
+    addMix(ch, stickSource(ELE_STICK), 20, BENCH_SW_FM1);
+    mix = addMix(ch, stickSource(THR_STICK), 60, SWSRC_SW2);
+    setMixCurve(mix, 5);
+  }
+  // elevator with snap flap and crow compensation
+  addMix(2, stickSource(ELE_STICK));
+  mix = addMix(2, stickSource(THR_STICK), -15, SWSRC_SW2);
+  setMixCurve(mix, 4);
+  addMix(3, stickSource(RUD_STICK));
+  mix = addMix(3, stickSource(AIL_STICK), 30);
+  mix->flightModes = 0x01;
+  // flaps
+  for (uint8_t ch=4; ch<6; ch++) {
+    addMix(ch, stickSource(ELE_STICK), -25, BENCH_SW_FM1);
+    mix = addMix(ch, stickSource(THR_STICK), -100, SWSRC_SW2);
+    setMixCurve(mix, 3);
+    mix->delayUp = 5;
+    mix->speedDown = 10;
+  }
+
+  setCurves(false);
+}
+
+static void setup32ch()
+{
+  modelDefault(0);
+  memclear(g_model.mixData, sizeof(g_model.mixData));
+
+  for (uint8_t i=0; i<NUM_LOGICAL_SWITCH; i++) {
+    switch (i % 4) {
+      case 0:
+        setLogicalSwitch(i, LS_FUNC_VPOS, stickSource(i % NUM_STICKS), -90 + 6*i);
+        break;
+      case 1:
+        setLogicalSwitch(i, LS_FUNC_ANEG, stickSource(i % NUM_STICKS), 50);
+        break;
+      case 2:
+        setLogicalSwitch(i, LS_FUNC_AND, SWSRC_SW1+i-2, SWSRC_SW1+i-1);
+        break;
+      default:
+        setLogicalSwitch(i, LS_FUNC_GREATER, stickSource(i % NUM_STICKS), stickSource((i+1) % NUM_STICKS));
+        break;
+    }
+  }
+
+  for (uint8_t ch=0; ch<NUM_CHNOUT; ch++) {
+    addMix(ch, stickSource(ch % NUM_STICKS));
+    addMix(ch, MIXSRC_SW1 + ch % NUM_LOGICAL_SWITCH, 25);
+  }
+
+  setCurves(false);
+}
+
+#if defined(GVARS)
+static void setupGvars()
+{
+  modelDefault(0);
+  memclear(g_model.mixData, sizeof(g_model.mixData));
+
+  g_model.flightModeData[1].swtch = BENCH_SW_FM1;
+  g_model.flightModeData[2].swtch = BENCH_SW_FM2;
+  g_model.flightModeData[3].swtch = BENCH_SW_FM3;
+  for (uint8_t gv=0; gv<MAX_GVARS; gv++) {
+    g_model.flightModeData[0].gvars[gv] = 10*gv;
+    // FM1 has its own values, FM2 and FM3 inherit from the previous flight mode
+    g_model.flightModeData[1].gvars[gv] = 100 - 10*gv;
+    g_model.flightModeData[2].gvars[gv] = GVAR_MAX+2;
+    g_model.flightModeData[3].gvars[gv] = GVAR_MAX+3;
+  }
+
+  for (uint8_t ch=0; ch<16; ch++) {
+    for (uint8_t stick=0; stick<NUM_STICKS; stick++) {
+      addMix(ch, stickSource(stick), GV1_LARGE + (ch+stick) % MAX_GVARS);
+    }
+  }
+}
+#endif
+
+const BenchModel benchModels[] = {
+  { "default", setupDefault },
+  { "heli", setupHeli },
+  { "glider", setupGlider },
+  { "32ch", setup32ch },
+#if defined(GVARS)
+  { "gvars", setupGvars },
+#endif
+  { NULL, NULL }
+};
@@ -204,6 +204,241 @@ const pm_char * bmpLoad(uint8_t *bmp, const char *filename, const unsigned int w
   return 0;
 }
 
+// The decoded bitmaps are packed at the start of the arena in their allocation order, each one followed by
+// its path, and the arena is compacted on eviction: the entries are referenced by their id, the pointers
+// given by bmpCacheGet() are only valid until the next bmpCacheLoad()
+static uint8_t bitmapCacheArena[BITMAP_CACHE_SIZE];
+static BitmapCacheEntry bitmapCacheEntries[BITMAP_CACHE_ENTRIES];
+static uint8_t bitmapCacheCount;
+static uint16_t bitmapCacheUsed;
+static uint16_t bitmapCacheHeld;
+static uint16_t bitmapCacheClock;
+static uint16_t bitmapCacheLastId;
+
+static const char * bmpCachePath(const BitmapCacheEntry & entry)
+{
+  const uint8_t * bmp = &bitmapCacheArena[entry.offset];
+  return (const char *)bmp + BITMAP_BUFFER_SIZE(bmp[0], bmp[1]);
+}
+
+static BitmapCacheEntry * bmpCacheFind(uint16_t id)
+{
+  for (uint8_t i=0; i<bitmapCacheCount; i++) {
+    if (bitmapCacheEntries[i].id == id) {
+      return &bitmapCacheEntries[i];
+    }
+  }
+  return NULL;
+}
+
+static void bmpCacheRemove(uint8_t index)
+{
+  BitmapCacheEntry & entry = bitmapCacheEntries[index];
+  uint16_t size = entry.size;
+  uint16_t end = entry.offset + size;
+  memmove(&bitmapCacheArena[entry.offset], &bitmapCacheArena[end], bitmapCacheUsed - end);
+  bitmapCacheUsed -= size;
+  for (uint8_t i=index; i<bitmapCacheCount-1; i++) {
+    bitmapCacheEntries[i] = bitmapCacheEntries[i+1];
+    bitmapCacheEntries[i].offset -= size;
+  }
+  bitmapCacheCount--;
+}
+
+// evicts the least recently used entries which are not held until there is room for a new entry of size bytes
+static bool bmpCacheMakeRoom(uint16_t size)
+{
+  // a bitmap which would not fit even once all the other entries are evicted doesn't flush them
+  if (size > BITMAP_CACHE_SIZE - bitmapCacheHeld) {
+    return false;
+  }
+  while (bitmapCacheCount == BITMAP_CACHE_ENTRIES || bitmapCacheUsed + size > BITMAP_CACHE_SIZE) {
+    int lru = -1;
+    for (uint8_t i=0; i<bitmapCacheCount; i++) {
+      const BitmapCacheEntry & entry = bitmapCacheEntries[i];
+      if (!entry.holds && (lru < 0 || (uint16_t)(bitmapCacheClock - entry.lastUse) > (uint16_t)(bitmapCacheClock - bitmapCacheEntries[lru].lastUse))) {
+        lru = i;
+      }
+    }
+    if (lru < 0) {
+      return false;
+    }
+    bmpCacheRemove(lru);
+  }
+  return true;
+}
+
+// the size of the bitmap, read from the headers before a decoding, without any check of the palette / data
+static bool bmpGetSize(const char * filename, uint32_t & w, uint32_t & h)
+{
+  FIL bmpFile;
+  UINT read;
+  uint8_t buf[26];
+
+  if (f_open(&bmpFile, filename, FA_OPEN_EXISTING | FA_READ) != FR_OK) {
+    return false;
+  }
+  FRESULT result = f_read(&bmpFile, buf, sizeof(buf), &read);
+  f_close(&bmpFile);
+  if (result != FR_OK || read != sizeof(buf) || buf[0] != 'B' || buf[1] != 'M') {
+    return false;
+  }
+
+  switch (*((uint32_t *)&buf[14])) {
+    case  40: // windib
+    case  56: // windib v3
+    case  64: // OS/2 v2
+    case 108: // windib v4
+    case 124: // windib v5
+      w = *((uint32_t *)&buf[18]);
+      h = *((uint32_t *)&buf[22]);
+      return true;
+    case  12: // OS/2 v1
+      w = *((uint16_t *)&buf[18]);
+      h = *((uint16_t *)&buf[20]);
+      return true;
+    default:
+      return false;
+  }
+}
+
+void bmpCacheReset()
+{
+  bitmapCacheCount = 0;
+  bitmapCacheUsed = 0;
+  bitmapCacheHeld = 0;
+}
+
+uint16_t bmpCacheLoad(const char * filename, const unsigned int width, const unsigned int height)
+{
+  FILINFO info;
+  info.lfname = NULL;
+  info.lfsize = 0;
+  bool statDone = false;
+  tmr10ms_t now = get_tmr10ms();
+
+  bitmapCacheClock++;
+
+  for (uint8_t i=0; i<bitmapCacheCount; i++) {
+    BitmapCacheEntry & entry = bitmapCacheEntries[i];
+    if (entry.stale || strcmp(bmpCachePath(entry), filename)) {
+      continue;
+    }
+    if ((tmr10ms_t)(now - entry.lastCheck) >= BITMAP_CACHE_CHECK_PERIOD) {
+      statDone = true;
+      if (f_stat(filename, &info) != FR_OK) {
+        if (!entry.holds) bmpCacheRemove(i);
+        return 0;
+      }
+      if (info.fsize != entry.fsize || info.fdate != entry.fdate || info.ftime != entry.ftime) {
+        // the file has been modified, a held entry stays reachable by its id until it is released
+        if (entry.holds)
+          entry.stale = true;
+        else
+          bmpCacheRemove(i);
+        break;
+      }
+      entry.lastCheck = now;
+    }
+    entry.lastUse = bitmapCacheClock;
+    const uint8_t * bmp = &bitmapCacheArena[entry.offset];
+    return (bmp[0] <= width && bmp[1] <= height) ? entry.id : 0;
+  }
+
+  if (!statDone && f_stat(filename, &info) != FR_OK) {
+    return 0;
+  }
+
+  // the room is taken for the real size of the bitmap, not for the biggest one the caller accepts
+  uint32_t w, h;
+  if (!bmpGetSize(filename, w, h) || w > width || h > height) {
+    return 0;
+  }
+
+  uint16_t pathSize = strlen(filename) + 1;
+  if (!bmpCacheMakeRoom(BITMAP_BUFFER_SIZE(w, h) + pathSize)) {
+    TRACE("bmpCacheLoad(%s): no room", filename);
+    return 0;
+  }
+
+  uint8_t * bmp = &bitmapCacheArena[bitmapCacheUsed];
+  if (bmpLoad(bmp, filename, w, h)) {
+    return 0;
+  }
+
+  do {
+    bitmapCacheLastId++;
+  } while (bitmapCacheLastId == 0 || bmpCacheFind(bitmapCacheLastId));
+
+  uint16_t size = BITMAP_BUFFER_SIZE(bmp[0], bmp[1]);
+  memcpy(bmp + size, filename, pathSize);
+  size += pathSize;
+
+  BitmapCacheEntry & entry = bitmapCacheEntries[bitmapCacheCount++];
+  entry.offset = bitmapCacheUsed;
+  entry.size = size;
+  entry.id = bitmapCacheLastId;
+  entry.lastUse = bitmapCacheClock;
+  entry.lastCheck = now;
+  entry.fsize = info.fsize;
+  entry.fdate = info.fdate;
+  entry.ftime = info.ftime;
+  entry.holds = 0;
+  entry.stale = false;
+  bitmapCacheUsed += size;
+
+  return entry.id;
+}
+
+const uint8_t * bmpCacheGet(uint16_t id)
+{
+  BitmapCacheEntry * entry = bmpCacheFind(id);
+  if (!entry) {
+    return NULL;
+  }
+  entry->lastUse = ++bitmapCacheClock;
+  return &bitmapCacheArena[entry->offset];
+}
+
+bool bmpCacheHold(uint16_t id)
+{
+  BitmapCacheEntry * entry = bmpCacheFind(id);
+  if (!entry || entry->holds == 255) {
+    return false;
+  }
+  if (entry->holds == 0) {
+    // the held entries always leave room for the model bitmap
+    if (bitmapCacheHeld + entry->size > BITMAP_CACHE_HOLD_MAX) {
+      return false;
+    }
+    bitmapCacheHeld += entry->size;
+  }
+  entry->holds++;
+  return true;
+}
+
+void bmpCacheRelease(uint16_t id)
+{
+  BitmapCacheEntry * entry = bmpCacheFind(id);
+  if (entry && entry->holds && --entry->holds == 0) {
+    bitmapCacheHeld -= entry->size;
+    if (entry->stale) {
+      bmpCacheRemove(entry - bitmapCacheEntries);
+    }
+  }
+}
+
+void bmpCacheReleaseAll()
+{
+  for (int i=bitmapCacheCount-1; i>=0; i--) {
+    bitmapCacheEntries[i].holds = 0;
+    if (bitmapCacheEntries[i].stale) {
+      bmpCacheRemove(i);
+    }
+  }
+  bitmapCacheHeld = 0;
+}
+
 const uint8_t bmpHeader[] = {
   0x42, 0x4d, 0xF8, 0x1A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x76, 0x00, 0x00, 0x00, 0x28, 0x00,
   0x00, 0x00, 212,  0x00, 0x00, 0x00, 64,   0x00, 0x00, 0x00, 0x01, 0x00, 0x04, 0x00, 0x00, 0x00,
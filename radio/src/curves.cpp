@@ -37,6 +37,8 @@
 #include "opentx.h"
 
 #if defined(XCURVES)
+void computeCurveTable(uint8_t idx);
+
 int8_t *curveEnd[MAX_CURVES];
 void loadCurves()
 {
@@ -57,6 +59,9 @@ void loadCurves()
     }
     curveEnd[i] = tmp;
   }
+  for (int i=0; i<MAX_CURVES; i++) {
+    computeCurveTable(i);
+  }
 }
 int8_t *curveAddress(uint8_t idx)
 {
@@ -152,6 +157,22 @@ s32 compute_tangent(CurveInfo *crv, int8_t *points, int i)
     return m;
 }
 
+int16_t hermite_segment(s32 x, s32 p0x, s32 p3x, s32 p0y, s32 p3y, s32 m0, s32 m3)
+{
+  s32 y;
+  s32 h = p3x - p0x;
+  s32 t = (h > 0 ? (MMULT * (x - p0x)) / h : 0);
+  s32 t2 = t * t / MMULT;
+  s32 t3 = t2 * t / MMULT;
+  s32 h00 = 2*t3 - 3*t2 + MMULT;
+  s32 h10 = t3 - 2*t2 + t;
+  s32 h01 = -2*t3 + 3*t2;
+  s32 h11 = t3 - t2;
+  y = p0y * h00 + h * (m0 * h10 / MMULT) + p3y * h01 + h * (m3 * h11 / MMULT);
+  y /= MMULT;
+  return y;
+}
+
 /* The following is a hermite cubic spline.
    The basis functions can be found here:
    http://en.wikipedia.org/wiki/Cubic_Hermite_spline
@@ -181,28 +202,20 @@ int16_t hermite_spline(int16_t x, uint8_t idx)
     }
 
     if (x >= p0x && x <= p3x) {
-      s32 p0y = calc100toRESX(points[i]);
-      s32 p3y = calc100toRESX(points[i+1]);
-      s32 m0 = compute_tangent(&crv, points, i);
-      s32 m3 = compute_tangent(&crv, points, i+1);
-      s32 y;
-      s32 h = p3x - p0x;
-      s32 t = (h > 0 ? (MMULT * (x - p0x)) / h : 0);
-      s32 t2 = t * t / MMULT;
-      s32 t3 = t2 * t / MMULT;
-      s32 h00 = 2*t3 - 3*t2 + MMULT;
-      s32 h10 = t3 - 2*t2 + t;
-      s32 h01 = -2*t3 + 3*t2;
-      s32 h11 = t3 - t2;
-      y = p0y * h00 + h * (m0 * h10 / MMULT) + p3y * h01 + h * (m3 * h11 / MMULT);
-      y /= MMULT;
-      return y;
+      return hermite_segment(x, p0x, p3x, calc100toRESX(points[i]), calc100toRESX(points[i+1]), compute_tangent(&crv, points, i), compute_tangent(&crv, points, i+1));
     }
   }
   return 0;
 }
 #endif
 
+// x, a and b from 0 to 2*RESX
+FORCEINLINE int intpol_segment(uint16_t x, uint16_t a, uint16_t b, int8_t y0, int8_t y1)
+{
+  int16_t erg = (int16_t)y0*(RESX/4) + ((int32_t)(x-a) * (y1-y0) * (RESX/4)) / ((b-a));
+  return erg / 25; // 100*D5/RESX;
+}
+
 int intpol(int x, uint8_t idx) // -100, -75, -50, -25, 0 ,25 ,50, 75, 100
 {
 #if defined(XCURVES)
@@ -242,7 +255,7 @@ int intpol(int x, uint8_t idx) // -100, -75, -50, -25, 0 ,25 ,50, 75, 100
       a = i * d;
       b = a + d;
     }
-    erg = (int16_t)points[i]*(RESX/4) + ((int32_t)(x-a) * (points[i+1]-points[i]) * (RESX/4)) / ((b-a));
+    return intpol_segment(x, a, b, points[i], points[i+1]);
   }
 
   return erg / 25; // 100*D5/RESX;
@@ -301,17 +314,126 @@ int applyCurve(int x, CurveRef & curve)
   return x;
 }
 
-int applyCustomCurve(int x, uint8_t idx)
-{
-  if (idx >= MAX_CURVES)
-    return 0;
+// The segments bounds and tangents of each custom curve are computed when the
+// model is loaded, plus an index giving the segment for every 32 steps of
+// input, so that the mixer doesn't need to scan the points on each call.
+// The curves editor invalidates the table of the curve it changes, which is
+// then computed again on its next use.
+#define CURVE_INDEX_SHIFT  5
+#define CURVE_INDEX_SIZE   ((2*RESX >> CURVE_INDEX_SHIFT) + 1)
 
+struct CurveTable {
+  bool      dirty;
+  bool      valid;     // false while the table is computed, the curve is computed directly meanwhile
+  bool      direct;
+  CurveInfo info;      // the definition the table has been computed for
+  int16_t   x[MAX_POINTS];
+  s32       tangents[MAX_POINTS];
+  uint8_t   index[CURVE_INDEX_SIZE];
+};
+
+CurveTable curveTables[MAX_CURVES];
+
+int computeCustomCurve(int x, uint8_t idx)
+{
   CurveInfo &crv = g_model.curves[idx];
   if (crv.smooth)
     return hermite_spline(x, idx);
   else
     return intpol(x, idx);
 }
+
+void computeCurveTable(uint8_t idx)
+{
+  CurveTable & table = curveTables[idx];
+  CurveInfo & crv = g_model.curves[idx];
+  int8_t * points = curveAddress(idx);
+  uint8_t count = crv.points + 5;
+
+  // cleared first, a change of the curve while the table is computed sets it again
+  table.dirty = false;
+  table.valid = false;
+
+  // linear curves with fixed X are already computed without scanning the points
+  table.direct = (count < 2 || count > MAX_POINTS || (!crv.smooth && crv.type != CURVE_TYPE_CUSTOM));
+
+  if (!table.direct) {
+    for (int i=0; i<count; i++) {
+      if (crv.type == CURVE_TYPE_CUSTOM)
+        table.x[i] = (i==0 ? -RESX : (i==count-1 ? RESX : calc100toRESX(points[count+i-1])));
+      else
+        table.x[i] = -RESX + (i*2*RESX)/(count-1);
+      if (i > 0 && table.x[i] < table.x[i-1]) {
+        // X not monotonic, the segment lookup wouldn't give the same result
+        table.direct = true;
+        break;
+      }
+      if (crv.smooth) {
+        table.tangents[i] = compute_tangent(&crv, points, i);
+      }
+    }
+  }
+
+  if (!table.direct) {
+    uint8_t segment = 0;
+    for (int i=0; i<CURVE_INDEX_SIZE; i++) {
+      int x = -RESX + (i << CURVE_INDEX_SHIFT);
+      while (segment < count-2 && x > table.x[segment+1]) {
+        segment++;
+      }
+      table.index[i] = segment;
+    }
+  }
+
+  table.info = crv;
+  table.valid = true;
+}
+
+void invalidateCurveTable(uint8_t idx)
+{
+  curveTables[idx].dirty = true;
+}
+
+int applyCustomCurve(int x, uint8_t idx)
+{
+  if (idx >= MAX_CURVES)
+    return 0;
+
+  CurveTable & table = curveTables[idx];
+  if (table.dirty) {
+    computeCurveTable(idx);
+  }
+
+  if (!table.valid || table.direct) {
+    return computeCustomCurve(x, idx);
+  }
+
+  int8_t * points = curveAddress(idx);
+  uint8_t count = table.info.points + 5;
+
+  if (x < -RESX)
+    x = -RESX;
+  else if (x > RESX)
+    x = RESX;
+
+  uint8_t i = table.index[(x + RESX) >> CURVE_INDEX_SHIFT];
+  while (x > table.x[i+1]) {
+    i++;
+  }
+
+  if (table.info.smooth) {
+    return hermite_segment(x, table.x[i], table.x[i+1], calc100toRESX(points[i]), calc100toRESX(points[i+1]), table.tangents[i], table.tangents[i+1]);
+  }
+  else if (x == -RESX) {
+    return ((int16_t)points[0] * (RESX/4)) / 25;
+  }
+  else if (x == RESX) {
+    return ((int16_t)points[count-1] * (RESX/4)) / 25;
+  }
+  else {
+    return intpol_segment(x+RESXu, table.x[i]+RESXu, table.x[i+1]+RESXu, points[i], points[i+1]);
+  }
+}
 #elif defined(CURVES)
 int applyCurve(int x, int8_t idx)
 {
@@ -420,7 +542,11 @@ unsigned int expou(unsigned int x, unsigned int k)
   return value>>8;
 }
 
+#if defined(CPUARM)
+int computeExpo(int x, int k)
+#else
 int expo(int x, int k)
+#endif
 {
   if (k == 0) return x;
   int y;
@@ -435,3 +561,76 @@ int expo(int x, int k)
   }
   return neg? -y : y;
 }
+
+#if defined(CPUARM)
+// The expo curves in use (after GVARs / flight modes resolution) are kept in
+// a few tables shared by all inputs and mixes using the same expo value.
+// A table not used for EXPO_TABLE_TIMEOUT may be reused for another value,
+// when all tables are in use the expo is computed as before.
+// The tables hold one point every 4 input steps (2KB for the 4 tables),
+// the points in between are interpolated, at most 1 step away from the
+// computed expo.
+#define EXPO_TABLES_COUNT     4
+#define EXPO_TABLE_TIMEOUT    100 /*1s*/
+#define EXPO_TABLE_SHIFT      2
+#define EXPO_TABLE_SIZE       ((RESX >> EXPO_TABLE_SHIFT) + 1)
+
+struct ExpoTable {
+  int8_t    k;         // 0 when the table is not (yet) usable
+  tmr10ms_t lastUsed;  // 0 when the table has never been used
+  uint16_t  values[EXPO_TABLE_SIZE];
+};
+
+ExpoTable expoTables[EXPO_TABLES_COUNT];
+
+uint16_t * getExpoTable(int k)
+{
+  tmr10ms_t now = get_tmr10ms();
+  ExpoTable * result = NULL;
+
+  for (int i=0; i<EXPO_TABLES_COUNT; i++) {
+    ExpoTable & table = expoTables[i];
+    if (table.k == k) {
+      table.lastUsed = now;
+      return table.values;
+    }
+    if (!result && (table.lastUsed == 0 || (tmr10ms_t)(now - table.lastUsed) >= EXPO_TABLE_TIMEOUT)) {
+      result = &table;
+    }
+  }
+
+  if (!result) {
+    return NULL;
+  }
+
+  // another task may use the expo while we are writing the table
+  result->k = 0;
+  result->lastUsed = now ? now : 1;
+  for (int i=0; i<EXPO_TABLE_SIZE; i++) {
+    result->values[i] = computeExpo(i << EXPO_TABLE_SHIFT, k);
+  }
+  result->k = k;
+  return result->values;
+}
+
+int expo(int x, int k)
+{
+  if (k == 0) return x;
+
+  if (x >= -RESX && x <= RESX) {
+    uint16_t * values = getExpoTable(k);
+    if (values) {
+      int ax = abs(x);
+      int i = ax >> EXPO_TABLE_SHIFT;
+      int y = values[i];
+      int rest = ax - (i << EXPO_TABLE_SHIFT);
+      if (rest) {
+        y += ((values[i+1] - y) * rest + (1 << (EXPO_TABLE_SHIFT-1))) >> EXPO_TABLE_SHIFT;
+      }
+      return x < 0 ? -y : y;
+    }
+  }
+
+  return computeExpo(x, k);
+}
+#endif
@@ -178,8 +178,12 @@ void debugTask(void* pdata)
 
   for (;;) {
 		
-    while ( (USART3->SR & USART_SR_RXNE) == 0 )
+    while ( (USART3->SR & USART_SR_RXNE) == 0 ) {
       CoTickDelay(5); // 10ms
+#if defined(TASKS_PROFILE)
+      tasksProfileStream();
+#endif
+    }
 		
     rxchar = USART3->DR;
 
@@ -242,12 +246,206 @@ void debugTask(void* pdata)
       crlf();
     }
 
+#if defined(MIXER_PROFILE)
+    if ( rxchar == 'p' )
+    {
+      crlf();
+      dumpMixerProfile();
+    }
+#endif
+
+#if defined(TASKS_PROFILE)
+    if ( rxchar == 't' )
+    {
+      crlf();
+      tasksProfileStreaming = !tasksProfileStreaming;
+    }
+#endif
+
   }
 }
 #endif  // #if !defined(SIMU)
 #endif  // #if (defined(DEBUG) && defined(CPUARM)) || defined(SIMU)
 
 
+#if defined(MIXER_PROFILE)
+
+MixerProfileStage mixerProfile[MIXER_STAGE_COUNT];
+const char * const mixerProfileStageNames[MIXER_STAGE_COUNT] = { "ADC", "Switches", "Inputs", "L.Switches", "Mixes", "Functions", "Limits" };
+
+// a stage may run several times in a cycle (flight modes fading)
+static uint16_t mixerProfileCycle[MIXER_STAGE_COUNT];
+static uint16_t mixerProfileMarkTime;
+
+void mixerProfileStart()
+{
+  memclear(mixerProfileCycle, sizeof(mixerProfileCycle));
+  mixerProfileMarkTime = getTmr2MHz();
+}
+
+void mixerProfileMark()
+{
+  mixerProfileMarkTime = getTmr2MHz();
+}
+
+void mixerProfileStage(uint8_t stage)
+{
+  uint16_t now = getTmr2MHz();
+  mixerProfileCycle[stage] += (uint16_t)(now - mixerProfileMarkTime);
+  mixerProfileMarkTime = now;
+}
+
+void mixerProfileEnd()
+{
+  for (uint8_t i=0; i<MIXER_STAGE_COUNT; i++) {
+    MixerProfileStage & stage = mixerProfile[i];
+    uint16_t duration = mixerProfileCycle[i];
+    if (stage.count == 0 || duration < stage.min) stage.min = duration;
+    if (duration > stage.max) stage.max = duration;
+    stage.sum += duration;
+    stage.count++;
+    uint8_t bucket = 0;
+    while (duration && bucket < MIXER_PROFILE_BUCKETS-1) {
+      duration >>= 1;
+      bucket++;
+    }
+    stage.histogram[bucket]++;
+  }
+}
+
+void mixerProfileReset()
+{
+  memclear(mixerProfile, sizeof(mixerProfile));
+}
+
+void dumpMixerProfile()
+{
+  TRACE("Mixer profile (0.5us): stage,min,mean,max,cycles,histogram[%d]", MIXER_PROFILE_BUCKETS);
+  for (uint8_t i=0; i<MIXER_STAGE_COUNT; i++) {
+    const MixerProfileStage & stage = mixerProfile[i];
+    TRACE_INFO_WP("%s,%d,%d,%d,%d", mixerProfileStageNames[i], stage.min, stage.count ? (int)(stage.sum / stage.count) : 0, stage.max, (int)stage.count);
+    for (uint8_t bucket=0; bucket<MIXER_PROFILE_BUCKETS; bucket++) {
+      TRACE_INFO_WP(",%d", (int)stage.histogram[bucket]);
+    }
+    TRACE_INFO_WP("\r\n");
+  }
+}
+
+#endif // #if defined(MIXER_PROFILE)
+
+
+#if defined(TASKS_PROFILE)
+
+TaskProfile tasksProfile[TASKS_PROFILE_COUNT];
+uint16_t maxMixerSchedulingLatency;
+uint16_t mixerWakeupTime;
+bool mixerWakeupPending;
+bool tasksProfileStreaming;
+
+static uint16_t isrProfileEnterTime;
+static uint16_t isrProfileDuration; // time spent in the ISRs since the last task switch
+static uint8_t isrProfileNesting;
+
+void tasksProfileRegister(uint8_t id, const char * name, uint8_t stack)
+{
+  if (id < TASKS_PROFILE_COUNT) {
+    tasksProfile[id].name = name;
+    tasksProfile[id].stack = stack;
+  }
+}
+
+#if !defined(SIMU)
+extern OS_TID mixerTaskId;
+static uint16_t tasksProfileSwitchTime;
+
+// called by the scheduler, the mixer task runs at least each 2ms, the 16 bits timer doesn't wrap between two switches
+extern "C" void CoTaskSwitchHook(OS_TID from, OS_TID to)
+{
+  uint16_t now = getTmr2MHz();
+  uint16_t duration = now - tasksProfileSwitchTime;
+  tasksProfile[from].runtime += (duration > isrProfileDuration ? duration - isrProfileDuration : 0);
+  tasksProfileSwitchTime = now;
+  isrProfileDuration = 0;
+
+  if (to == mixerTaskId && mixerWakeupPending) {
+    uint16_t latency = now - mixerWakeupTime;
+    if (latency > maxMixerSchedulingLatency) maxMixerSchedulingLatency = latency;
+    mixerWakeupPending = false;
+  }
+}
+#endif
+
+void isrProfileEnter()
+{
+  if (isrProfileNesting++ == 0) {
+    isrProfileEnterTime = getTmr2MHz();
+  }
+}
+
+void isrProfileExit()
+{
+  if (--isrProfileNesting == 0) {
+    uint16_t duration = getTmr2MHz() - isrProfileEnterTime;
+    tasksProfile[TASKS_PROFILE_ISR_SLOT].runtime += duration;
+    isrProfileDuration += duration;
+  }
+}
+
+void tasksProfileUpdate()
+{
+  static tmr10ms_t lastTime;
+  static uint32_t lastRuntime[TASKS_PROFILE_COUNT];
+
+  tmr10ms_t now = get_tmr10ms();
+  if ((tmr10ms_t)(now - lastTime) < TASKS_PROFILE_PERIOD) {
+    return;
+  }
+  lastTime = now;
+
+  uint32_t durations[TASKS_PROFILE_COUNT];
+  uint32_t total = 0;
+  for (uint8_t i=0; i<TASKS_PROFILE_COUNT; i++) {
+    uint32_t runtime = tasksProfile[i].runtime;
+    durations[i] = runtime - lastRuntime[i];
+    lastRuntime[i] = runtime;
+    total += durations[i];
+  }
+  for (uint8_t i=0; i<TASKS_PROFILE_COUNT; i++) {
+    tasksProfile[i].load = (total ? (uint64_t)durations[i] * 1000 / total : 0);
+  }
+}
+
+void tasksProfileReset()
+{
+  maxMixerSchedulingLatency = 0;
+}
+
+void dumpTasksProfile()
+{
+  TRACE("Tasks profile: task,load (per mille),stack free (bytes)");
+  for (uint8_t i=0; i<TASKS_PROFILE_COUNT; i++) {
+    const TaskProfile & task = tasksProfile[i];
+    if (task.name) {
+      TRACE("%s,%d,%d", task.name, task.load, task.stack == TASKS_PROFILE_NO_STACK ? -1 : (int)stack_free(task.stack));
+    }
+  }
+  TRACE("Mixer scheduling latency (0.5us): %d", maxMixerSchedulingLatency);
+}
+
+// called by the debug task, 't' toggles the dump each period
+void tasksProfileStream()
+{
+  static tmr10ms_t lastTime;
+  tmr10ms_t now = get_tmr10ms();
+  if (tasksProfileStreaming && (tmr10ms_t)(now - lastTime) >= TASKS_PROFILE_PERIOD) {
+    lastTime = now;
+    dumpTasksProfile();
+  }
+}
+
+#endif // #if defined(TASKS_PROFILE)
+
+
 #if defined(DEBUG_TRACE_BUFFER)
 
 static struct TraceElement traceBuffer[TRACE_BUFFER_LEN];
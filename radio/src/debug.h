@@ -155,6 +155,108 @@ void dumpTraceBuffer();
 
 #endif // #if defined(DEBUG_TRACE_BUFFER)
 
+#if defined(MIXER_PROFILE)
+
+// Duration of the mixer cycle stages, measured with the 2MHz timer (0.5us)
+enum MixerProfileStages {
+  MIXER_STAGE_ADC,
+  MIXER_STAGE_SWITCHES,
+  MIXER_STAGE_INPUTS,
+  MIXER_STAGE_LOGICAL_SWITCHES,
+  MIXER_STAGE_MIXES,
+  MIXER_STAGE_FUNCTIONS,
+  MIXER_STAGE_LIMITS,
+  MIXER_STAGE_COUNT
+};
+
+// bucket n counts the cycles where the stage took [2^(n-1), 2^n[ timer ticks
+#define MIXER_PROFILE_BUCKETS  16
+
+struct MixerProfileStage {
+  uint16_t min;
+  uint16_t max;
+  uint32_t sum;
+  uint32_t count;
+  uint32_t histogram[MIXER_PROFILE_BUCKETS];
+};
+
+extern MixerProfileStage mixerProfile[MIXER_STAGE_COUNT];
+extern const char * const mixerProfileStageNames[MIXER_STAGE_COUNT];
+
+void mixerProfileStart();
+void mixerProfileMark();
+void mixerProfileStage(uint8_t stage);
+void mixerProfileEnd();
+void mixerProfileReset();
+void dumpMixerProfile();
+
+#define MIXER_PROFILE_START()        mixerProfileStart()
+#define MIXER_PROFILE_MARK()         mixerProfileMark()
+#define MIXER_PROFILE_STAGE(stage)   mixerProfileStage(stage)
+#define MIXER_PROFILE_END()          mixerProfileEnd()
+
+#else // #if defined(MIXER_PROFILE)
+
+#define MIXER_PROFILE_START()
+#define MIXER_PROFILE_MARK()
+#define MIXER_PROFILE_STAGE(stage)
+#define MIXER_PROFILE_END()
+
+#endif // #if defined(MIXER_PROFILE)
+
+#if defined(TASKS_PROFILE)
+
+#include "OsConfig.h"
+
+// Runtime of the CoOS tasks, accumulated by the task switch hook with the 2MHz timer (0.5us). The
+// instrumented ISRs are deducted from the task they interrupted and accounted in their own slot
+#define TASKS_PROFILE_COUNT      (CFG_MAX_USER_TASKS+2) // CoOS idle task + CFG_MAX_USER_TASKS + ISRs
+#define TASKS_PROFILE_ISR_SLOT   (TASKS_PROFILE_COUNT-1)
+#define TASKS_PROFILE_NO_STACK   254
+#define TASKS_PROFILE_PERIOD     100 // the loads are computed each second
+
+struct TaskProfile {
+  const char * name;
+  uint8_t stack;     // stack_free() index
+  uint32_t runtime;
+  uint16_t load;     // per mille of the last period
+};
+
+extern TaskProfile tasksProfile[TASKS_PROFILE_COUNT];
+extern uint16_t maxMixerSchedulingLatency;
+extern uint16_t mixerWakeupTime;
+extern bool mixerWakeupPending;
+extern bool tasksProfileStreaming;
+
+void tasksProfileRegister(uint8_t id, const char * name, uint8_t stack);
+void tasksProfileUpdate();
+void tasksProfileReset();
+void dumpTasksProfile();
+void tasksProfileStream();
+void isrProfileEnter();
+void isrProfileExit();
+
+struct IsrProfileScope {
+  IsrProfileScope() { isrProfileEnter(); }
+  ~IsrProfileScope() { isrProfileExit(); }
+};
+
+#define TASKS_PROFILE_REGISTER(id, name, stack)  tasksProfileRegister(id, name, stack)
+#define TASKS_PROFILE_UPDATE()                   tasksProfileUpdate()
+#define TASKS_PROFILE_ISR()                      IsrProfileScope isrProfileScope
+#define TASKS_PROFILE_MIXER_WAKEUP()             do { mixerWakeupTime = getTmr2MHz(); mixerWakeupPending = true; } while(0)
+#define TASKS_PROFILE_MIXER_RUNNING()            mixerWakeupPending = false
+
+#else // #if defined(TASKS_PROFILE)
+
+#define TASKS_PROFILE_REGISTER(id, name, stack)
+#define TASKS_PROFILE_UPDATE()
+#define TASKS_PROFILE_ISR()
+#define TASKS_PROFILE_MIXER_WAKEUP()
+#define TASKS_PROFILE_MIXER_RUNNING()
+
+#endif // #if defined(TASKS_PROFILE)
+
 #if defined(TRACE_SD_CARD)
   #define TRACE_SD_CARD_EVENT(condition, event, data)  TRACE_EVENT(condition, event, data)
 #else
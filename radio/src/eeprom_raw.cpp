@@ -357,6 +357,7 @@ void eeLoadModel(uint8_t id)
       eeCheck(true);
     }
 
+    INVALIDATE_MIXER_PROGRAM();
     AUDIO_FLUSH();
     flightReset();
     logicalSwitchesReset();
@@ -972,6 +972,7 @@ void eeLoadModel(uint8_t id)
       newModel = true;
     }
 
+    INVALIDATE_MIXER_PROGRAM();
     AUDIO_FLUSH();
     flightReset();
     logicalSwitchesReset();
@@ -199,6 +199,16 @@ void menuModelPhaseOne(uint8_t event)
 #endif
     }
   }
+
+#if defined(CPUARM)
+  if (event) {
+    // the trims modes may have been edited, resolved again with the mixer paused
+    pauseMixerCalculations();
+    INVALIDATE_MIXER_PROGRAM();
+    checkFlightModesInheritance();
+    resumeMixerCalculations();
+  }
+#endif
 }
 
 #if defined(ROTARY_ENCODERS)
@@ -142,6 +142,7 @@ void deleteExpoMix(uint8_t expo, uint8_t idx)
     memmove(mix, mix+1, (MAX_MIXERS-(idx+1))*sizeof(MixData));
     memclear(&g_model.mixData[MAX_MIXERS-1], sizeof(MixData));
   }
+  INVALIDATE_MIXER_PROGRAM();
   resumeMixerCalculations();
   eeDirty(EE_MODEL);
 }
@@ -167,6 +168,7 @@ void insertExpoMix(uint8_t expo, uint8_t idx)
     mix->srcRaw = (s_currCh > 4 ? MIXSRC_Rud - 1 + s_currCh : MIXSRC_Rud - 1 + channel_order(s_currCh));
     mix->weight = 100;
   }
+  INVALIDATE_MIXER_PROGRAM();
   resumeMixerCalculations();
   eeDirty(EE_MODEL);
 }
@@ -182,6 +184,7 @@ void copyExpoMix(uint8_t expo, uint8_t idx)
     MixData *mix = mixAddress(idx);
     memmove(mix+1, mix, (MAX_MIXERS-(idx+1))*sizeof(MixData));
   }
+  INVALIDATE_MIXER_PROGRAM();
   resumeMixerCalculations();
   eeDirty(EE_MODEL);
 }
@@ -199,7 +202,7 @@ void memswap(void *a, void *b, uint8_t size)
   }
 }
 
-bool swapExpoMix(uint8_t expo, uint8_t &idx, uint8_t up)
+static bool swapExpoMixLines(uint8_t expo, uint8_t &idx, uint8_t up)
 {
   void *x, *y;
   uint8_t size;
@@ -271,14 +274,22 @@ bool swapExpoMix(uint8_t expo, uint8_t &idx, uint8_t up)
     size = sizeof(MixData);
   }
 
-  pauseMixerCalculations();
   memswap(x, y, size);
-  resumeMixerCalculations();
 
   idx = tgt_idx;
   return true;
 }
 
+bool swapExpoMix(uint8_t expo, uint8_t &idx, uint8_t up)
+{
+  // the channel changes are also done with the mixer paused
+  pauseMixerCalculations();
+  bool result = swapExpoMixLines(expo, idx, up);
+  INVALIDATE_MIXER_PROGRAM();
+  resumeMixerCalculations();
+  return result;
+}
+
 enum ExposFields {
   CASE_CPUARM(EXPO_FIELD_NAME)
   EXPO_FIELD_WEIGHT,
@@ -368,6 +379,10 @@ void menuModelExpoOne(uint8_t event)
     y += FH;
   }
 
+  if (event) {
+    INVALIDATE_MIXER_PROGRAM(); // the line may have been edited
+  }
+
   DrawFunction(expoFn);
 
   int16_t x512 = calibratedStick[ed->chn];
@@ -621,6 +636,10 @@ void menuModelMixOne(uint8_t event)
         break;
     }
   }
+
+  if (event) {
+    INVALIDATE_MIXER_PROGRAM(); // the line may have been edited
+  }
 }
 
 static uint8_t s_maxLines = 8;
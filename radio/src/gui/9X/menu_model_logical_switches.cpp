@@ -233,6 +233,10 @@ void menuModelLogicalSwitchOne(uint8_t event)
         break;
     }
   }
+
+  if (event) {
+    INVALIDATE_MIXER_PROGRAM(); // the switch may have been edited
+  }
 }
 
 void menuModelLogicalSwitches(uint8_t event)
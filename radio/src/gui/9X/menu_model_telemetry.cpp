@@ -217,6 +217,12 @@ enum SensorFields {
   SENSOR_FIELD_MAX
 };
 
+// a sensor reading the edited one can't be one of its sources, the calculated sensors would loop
+bool isSensorLooping(int sensor)
+{
+  return sensor != 0 && isTelemetrySensorReading(abs(sensor)-1, s_currIdx);
+}
+
 bool isSensorUnit(int sensor, uint8_t unit)
 {
   if (sensor == 0)
@@ -229,7 +235,7 @@ bool isSensorUnit(int sensor, uint8_t unit)
 
 bool isCellsSensor(int sensor)
 {
-  return isSensorUnit(sensor, UNIT_CELLS);
+  return isSensorUnit(sensor, UNIT_CELLS) && !isSensorLooping(sensor);
 }
 
 bool isGPSSensor(int sensor)
@@ -242,6 +248,11 @@ bool isAltSensor(int sensor)
   return isSensorUnit(sensor, UNIT_DIST);
 }
 
+bool isAltSourceSensor(int sensor)
+{
+  return isAltSensor(sensor) && !isSensorLooping(sensor);
+}
+
 bool isVoltsSensor(int sensor)
 {
   return isSensorUnit(sensor, UNIT_VOLTS);
@@ -249,7 +260,7 @@ bool isVoltsSensor(int sensor)
 
 bool isCurrentSensor(int sensor)
 {
-  return isSensorUnit(sensor, UNIT_AMPS);
+  return isSensorUnit(sensor, UNIT_AMPS) && !isSensorLooping(sensor);
 }
 
 bool isSensorAvailable(int sensor)
@@ -260,6 +271,11 @@ bool isSensorAvailable(int sensor)
     return isTelemetryFieldAvailable(abs(sensor) - 1);
 }
 
+bool isSensorSourceAvailable(int sensor)
+{
+  return isSensorAvailable(sensor) && !isSensorLooping(sensor);
+}
+
 #define SENSOR_2ND_COLUMN (12*FW)
 #define SENSOR_3RD_COLUMN (18*FW)
 
@@ -425,7 +441,7 @@ void menuModelSensor(uint8_t event)
             lcd_putsLeft(y, STR_ALTSENSOR);
             putsMixerSource(SENSOR_2ND_COLUMN, y, sensor->dist.alt ? MIXSRC_FIRST_TELEM+3*(sensor->dist.alt-1) : 0, attr);
             if (attr) {
-              sensor->dist.alt = checkIncDec(event, sensor->dist.alt, 0, MAX_SENSORS, EE_MODEL|NO_INCDEC_MARKS, isAltSensor);
+              sensor->dist.alt = checkIncDec(event, sensor->dist.alt, 0, MAX_SENSORS, EE_MODEL|NO_INCDEC_MARKS, isAltSourceSensor);
             }
             break;
           }
@@ -447,7 +463,7 @@ void menuModelSensor(uint8_t event)
         putsStrIdx(0, y, NO_INDENT(STR_SOURCE), k-SENSOR_FIELD_PARAM1+1);
         int8_t & source = sensor->calc.sources[k-SENSOR_FIELD_PARAM1];
         if (attr) {
-          source = checkIncDec(event, source, -MAX_SENSORS, MAX_SENSORS, EE_MODEL|NO_INCDEC_MARKS, isSensorAvailable);
+          source = checkIncDec(event, source, -MAX_SENSORS, MAX_SENSORS, EE_MODEL|NO_INCDEC_MARKS, isSensorSourceAvailable);
         }
         if (source < 0) {
           lcd_putcAtt(SENSOR_2ND_COLUMN, y, '-', attr);
@@ -481,6 +497,10 @@ void menuModelSensor(uint8_t event)
 
     }
   }
+
+  if (event) {
+    INVALIDATE_MIXER_PROGRAM(); // the sensor may have been edited
+  }
 }
 
 void onSensorMenu(const char *result)
@@ -509,6 +529,7 @@ void onSensorMenu(const char *result)
         TelemetryItem & sourceItem = telemetryItems[index];
         TelemetryItem & newItem = telemetryItems[newIndex];
         newItem = sourceItem;
+        INVALIDATE_MIXER_PROGRAM();
         eeDirty(EE_MODEL);
       } 
       else {
@@ -37,23 +37,155 @@
 #include "../../opentx.h"
 #include "../../timers.h"
 
+// word aligned, the pages are hashed one word at a time
 #if defined(REVPLUS) && defined(LCD_DUAL_BUFFER)
-  display_t displayBuf1[DISPLAY_BUF_SIZE] _NOCCM;
-  display_t displayBuf2[DISPLAY_BUF_SIZE] _NOCCM;
+  display_t displayBuf1[DISPLAY_BUF_SIZE] __attribute__((aligned(4))) _NOCCM;
+  display_t displayBuf2[DISPLAY_BUF_SIZE] __attribute__((aligned(4))) _NOCCM;
   display_t * displayBuf = displayBuf1;
 #else
-  display_t displayBuf[DISPLAY_BUF_SIZE] _NOCCM;
+  display_t displayBuf[DISPLAY_BUF_SIZE] __attribute__((aligned(4))) _NOCCM;
 #endif
 
+// displayBuf is also accessed 4 bytes at a time
+typedef uint32_t lcd_word_t __attribute__((__may_alias__));
+
+uint32_t lcdDirtyPages = LCD_ALL_PAGES;
+uint32_t lcdPagesHash[LCD_PAGES];
+uint8_t lcdFullRefreshCounter = 0;
+
+void lcdInvalidatePages()
+{
+  lcdFullRefreshCounter = 0;
+}
+
+uint32_t lcdGetChangedPages()
+{
+  uint32_t changed = 0;
+
+  if (lcdFullRefreshCounter == 0) {
+    lcdFullRefreshCounter = LCD_FULL_REFRESH_PERIOD;
+    lcdDirtyPages = LCD_ALL_PAGES;
+    changed = LCD_ALL_PAGES;
+  }
+  lcdFullRefreshCounter--;
+
+  for (uint8_t page=0; page<LCD_PAGES; page++) {
+    if (lcdDirtyPages & (1 << page)) {
+      // FNV-1a on words
+      const lcd_word_t * p = (const lcd_word_t *)&displayBuf[page * LCD_W];
+      uint32_t hash = 2166136261u;
+      for (uint8_t i=0; i<LCD_W/4; i++) {
+        hash = (hash ^ *p++) * 16777619u;
+      }
+      if (hash != lcdPagesHash[page]) {
+        lcdPagesHash[page] = hash;
+        changed |= (1 << page);
+      }
+    }
+  }
+
+  lcdDirtyPages = 0;
+  return changed;
+}
+
 void lcd_clear()
 {
   memset(displayBuf, 0, DISPLAY_BUFER_SIZE);
+  lcdDirtyPages = LCD_ALL_PAGES;
+}
+
+#define PIXEL_GREY_MASK(y, att) (((y) & 1) ? (0xF0 - (COLOUR_MASK(att) >> 12)) : (0x0F - (COLOUR_MASK(att) >> 16)))
+
+static inline void lcdMaskByte(uint8_t * p, uint8_t mask, LcdFlags att)
+{
+  if (att & FORCE)
+    *p |= mask;
+  else if (att & ERASE)
+    *p &= ~mask;
+  else
+    *p ^= mask;
+}
+
+// Same result as lcd_mask() on w consecutive bytes, where pattern bit (i % 8) selects byte i,
+// the bytes are written 4 at a time once p is word aligned
+static void lcdMaskSpan(uint8_t * p, coord_t w, uint8_t mask, uint8_t pat, LcdFlags att)
+{
+  if (p < displayBuf) {
+    coord_t skip = min<coord_t>(displayBuf - p, max<coord_t>(w, 0));
+    p += skip;
+    w -= skip;
+    pat = (pat >> (skip & 7)) | (pat << (8 - (skip & 7)));
+  }
+  if (w > DISPLAY_END - p) {
+    w = DISPLAY_END - p;
+  }
+  if (w <= 0) {
+    return;
+  }
+
+  if (att & FILL_WHITE) {
+    // depends on each byte content, there is no shortcut
+    while (w--) {
+      if (pat & 1) {
+        lcd_mask(p, mask, att);
+      }
+      pat = (pat >> 1) | (pat << 7);
+      p++;
+    }
+    return;
+  }
+
+  while (w > 0 && ((uintptr_t)p & 3)) {
+    if (pat & 1) {
+      lcdMaskByte(p, mask, att);
+    }
+    pat = (pat >> 1) | (pat << 7);
+    p++;
+    w--;
+  }
+
+  if (w >= 4) {
+    // the pattern repeats every 8 bytes, i.e. every 2 words
+    uint32_t masks[2] = { 0, 0 };
+    for (uint8_t i=0; i<8; i++) {
+      if (pat & (1 << i)) {
+        masks[i/4] |= (uint32_t)mask << (8 * (i & 3));
+      }
+    }
+    lcd_word_t * q = (lcd_word_t *)p;
+    coord_t words = w / 4;
+    if (att & FORCE) {
+      for (coord_t i=0; i<words; i++)
+        *q++ |= masks[i & 1];
+    }
+    else if (att & ERASE) {
+      for (coord_t i=0; i<words; i++)
+        *q++ &= ~masks[i & 1];
+    }
+    else {
+      for (coord_t i=0; i<words; i++)
+        *q++ ^= masks[i & 1];
+    }
+    if (words & 1) {
+      pat = (pat >> 4) | (pat << 4);
+    }
+    p = (uint8_t *)q;
+    w -= 4 * words;
+  }
+
+  while (w-- > 0) {
+    if (pat & 1) {
+      lcdMaskByte(p, mask, att);
+    }
+    pat = (pat >> 1) | (pat << 7);
+    p++;
+  }
 }
 
 coord_t lcdLastPos;
 coord_t lcdNextPos;
 
-void lcdPutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width, uint8_t height, LcdFlags flags)
+static void lcdDrawPattern(void (*lcdPlot)(coord_t x, coord_t y, LcdFlags att), coord_t x, coord_t y, const uint8_t * pattern, uint8_t width, uint8_t height, LcdFlags flags)
 {
   bool blink = false;
   bool inv = false;
@@ -126,9 +258,9 @@ void lcdPutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width,
         if (inv) plot = !plot;
         if (!blink) {
           if (flags & VERTICAL)
-            lcd_plot(y+j, LCD_H-x, plot ? FORCE : ERASE);
+            lcdPlot(y+j, LCD_H-x, plot ? FORCE : ERASE);
           else
-            lcd_plot(x, y+j, plot ? FORCE : ERASE);
+            lcdPlot(x, y+j, plot ? FORCE : ERASE);
         }
       }
     }
@@ -138,6 +270,137 @@ void lcdPutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width,
   }
 }
 
+#if !defined(BOOT)
+// The glyphs are expanded once into the nibbles they touch and the values they write there,
+// page by page, then copied into displayBuf a word at a time
+GlyphCacheEntry glyphCache[GLYPH_CACHE_SIZE];
+uint8_t glyphCacheLru[GLYPH_CACHE_SIZE/2]; // the way used last in each set
+GlyphCacheStats glyphCacheStats;
+bool glyphCacheEnabled = true;
+
+static GlyphCacheEntry * glyphExpanded;
+static coord_t glyphExpandedX;
+static uint8_t glyphExpandedPage;
+
+static void glyphExpandPlot(coord_t x, coord_t y, LcdFlags att)
+{
+  coord_t col = x - glyphExpandedX;
+  coord_t page = y / 2 - glyphExpandedPage;
+  if (col < 0 || col >= GLYPH_MAX_COLS || page >= GLYPH_MAX_PAGES) {
+    glyphExpanded->pattern = NULL;
+    return;
+  }
+  uint8_t mask = (y & 1) ? 0xF0 : 0x0F;
+  glyphExpanded->touch[page][col] |= mask;
+  if (att & FORCE)
+    glyphExpanded->value[page][col] |= mask;
+  else
+    glyphExpanded->value[page][col] &= ~mask;
+  if (col >= glyphExpanded->cols) glyphExpanded->cols = col + 1;
+  if (page >= glyphExpanded->pages) glyphExpanded->pages = page + 1;
+}
+
+static void lcdBlitSpan(uint8_t * p, const uint8_t * touch, const uint8_t * value, uint8_t w)
+{
+  while (w > 0 && ((uintptr_t)p & 3)) {
+    *p = (*p & ~*touch++) | *value++;
+    p++;
+    w--;
+  }
+  while (w >= 4) {
+    uint32_t t, v;
+    memcpy(&t, touch, 4);
+    memcpy(&v, value, 4);
+    *(lcd_word_t *)p = (*(lcd_word_t *)p & ~t) | v;
+    p += 4;
+    touch += 4;
+    value += 4;
+    w -= 4;
+  }
+  while (w--) {
+    *p = (*p & ~*touch++) | *value++;
+    p++;
+  }
+}
+
+void glyphCacheReset()
+{
+  memclear(glyphCache, sizeof(glyphCache));
+  memclear(glyphCacheLru, sizeof(glyphCacheLru));
+  memclear(&glyphCacheStats, sizeof(glyphCacheStats));
+}
+
+void lcdPutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width, uint8_t height, LcdFlags flags)
+{
+  bool inv = (flags & INVERS);
+
+  // VERTICAL, blinking and clipped glyphs, as well as the big fonts, are drawn pixel by pixel
+  if (!glyphCacheEnabled || (flags & (VERTICAL|BLINK)) || height > GLYPH_MAX_HEIGHT || width+3 > GLYPH_MAX_COLS || x < 0 || x+width+2 > LCD_W || y < 0) {
+    lcdDrawPattern(lcd_plot, x, y, pattern, width, height, flags);
+    return;
+  }
+
+  // the column before the glyph is only drawn when INVERS, and not on the first column
+  uint8_t lead = (inv && x > 0) ? 1 : 0;
+  uint32_t key = width + (height << 8) + ((flags & (FIXEDWIDTH|CONDENSED)) << 16) + (FONTSIZE(flags) == SMLSIZE ? 1 << 24 : 0) + (inv << 25) + (lead << 26) + ((y & 1) << 27);
+  // 2 ways per set, the least recently used one is replaced
+  uint8_t set = ((((uintptr_t)pattern * 2654435761u) >> 8) ^ key ^ (key >> 24)) % (GLYPH_CACHE_SIZE/2);
+  uint8_t way = 0;
+  GlyphCacheEntry * entry = NULL;
+  for (; way<2; way++) {
+    if (glyphCache[2*set+way].pattern == pattern && glyphCache[2*set+way].key == key) {
+      entry = &glyphCache[2*set+way];
+      break;
+    }
+  }
+
+  if (entry) {
+    glyphCacheStats.hits++;
+  }
+  else {
+    way = !glyphCacheLru[set];
+    entry = &glyphCache[2*set+way];
+    glyphCacheStats.misses++;
+    if (entry->pattern) {
+      glyphCacheStats.used--;
+    }
+    memclear(entry, sizeof(GlyphCacheEntry));
+    entry->pattern = pattern;
+    entry->key = key;
+    // the glyph is drawn at a position with the same lead column and the same row parity
+    coord_t lcdNextPosSaved = lcdNextPos;
+    lcdNextPos = 0;
+    glyphExpanded = entry;
+    glyphExpandedX = 0;
+    glyphExpandedPage = (y & 1);
+    lcdDrawPattern(glyphExpandPlot, lead, 2 + (y & 1), pattern, width, height, flags);
+    entry->advance = lcdNextPos;
+    lcdNextPos = lcdNextPosSaved;
+    if (!entry->pattern) {
+      lcdDrawPattern(lcd_plot, x, y, pattern, width, height, flags);
+      return;
+    }
+    glyphCacheStats.used++;
+  }
+  glyphCacheLru[set] = way;
+
+  // the glyph was expanded 2 + (y & 1) rows below the top of the display
+  coord_t page = (y & 1) + (y - 2 - (y & 1)) / 2;
+  for (uint8_t i=0; i<entry->pages; i++, page++) {
+    if (page >= 0 && page < LCD_PAGES) {
+      lcdDirtyPages |= (1 << page);
+      lcdBlitSpan(&displayBuf[page * LCD_W + x - lead], entry->touch[i], entry->value[i], entry->cols);
+    }
+  }
+  lcdNextPos += entry->advance;
+}
+#else
+void lcdPutPattern(coord_t x, coord_t y, const uint8_t * pattern, uint8_t width, uint8_t height, LcdFlags flags)
+{
+  lcdDrawPattern(lcd_plot, x, y, pattern, width, height, flags);
+}
+#endif
+
 void lcd_putcAtt(coord_t x, coord_t y, const unsigned char c, LcdFlags flags)
 {
   const pm_uchar * q;
@@ -536,10 +799,18 @@ void lcd_rect(coord_t x, coord_t y, coord_t w, coord_t h, uint8_t pat, LcdFlags
 void drawFilledRect(coord_t x, scoord_t y, coord_t w, coord_t h, uint8_t pat, LcdFlags att)
 {
   for (scoord_t i=y; i<y+h; i++) {
-    if ((att&ROUND) && (i==y || i==y+h-1))
+    if ((att&ROUND) && (i==y || i==y+h-1)) {
       lcd_hlineStip(x+1, i, w-2, pat, att);
-    else
+    }
+    else if (pat == SOLID && !(att & FILL_WHITE) && !(i & 1) && i >= 0 && i+1 < LCD_H && i+1 < y+h && !((att&ROUND) && i+1 == y+h-1) && x >= 0 && x < LCD_W) {
+      // both rows of the page in one pass
+      LCD_DIRTY_ROWS(i, 2);
+      lcdMaskSpan(&displayBuf[i / 2 * LCD_W + x], min<coord_t>(w, LCD_W - x), PIXEL_GREY_MASK(0, att) | PIXEL_GREY_MASK(1, att), SOLID, att);
+      i++;
+    }
+    else {
       lcd_hlineStip(x, i, w, pat, att);
+    }
     pat = (pat >> 1) + ((pat & 1) << 7);
   }
 }
@@ -1006,13 +1277,12 @@ void lcd_mask(uint8_t *p, uint8_t mask, LcdFlags att)
   }
 }
 
-#define PIXEL_GREY_MASK(y, att) (((y) & 1) ? (0xF0 - (COLOUR_MASK(att) >> 12)) : (0x0F - (COLOUR_MASK(att) >> 16)))
-
 void lcd_plot(coord_t x, coord_t y, LcdFlags att)
 {
   if (x<0 || x>=LCD_W || y<0 || y>=LCD_H) return;
   uint8_t *p = &displayBuf[ y / 2 * LCD_W + x ];
   uint8_t mask = PIXEL_GREY_MASK(y, att);
+  LCD_DIRTY_ROW(y);
   lcd_mask(p, mask, att);
 }
 
@@ -1024,23 +1294,17 @@ void lcd_hlineStip(coord_t x, coord_t y, coord_t w, uint8_t pat, LcdFlags att)
     w = LCD_W - x;
   }
 
-  uint8_t *p  = &displayBuf[ y / 2 * LCD_W + x ];
-  uint8_t mask = PIXEL_GREY_MASK(y, att);
-  while (w--) {
-    if (pat&1) {
-      lcd_mask(p, mask, att);
-      pat = (pat >> 1) | 0x80;
-    }
-    else {
-      pat = pat >> 1;
-    }
-    p++;
+  LCD_DIRTY_ROW(y);
+  if (x < 0 && y >= 2) {
+    // the beginning of the line goes to the end of the previous page
+    LCD_DIRTY_ROW(y-2);
   }
+  lcdMaskSpan(&displayBuf[ y / 2 * LCD_W + x ], w, PIXEL_GREY_MASK(y, att), pat, att);
 }
 
 void lcd_vlineStip(coord_t x, scoord_t y, scoord_t h, uint8_t pat, LcdFlags att)
 {
-  if (x >= LCD_W) return;
+  if (x < 0 || x >= LCD_W) return;
   if (y >= LCD_H) return;
   if (h<0) { y+=h; h=-h; }
   if (y<0) { h+=y; y=0; if (h<=0) return; }
@@ -1050,13 +1314,24 @@ void lcd_vlineStip(coord_t x, scoord_t y, scoord_t h, uint8_t pat, LcdFlags att)
     pat = ~pat;
   }
 
+  LCD_DIRTY_ROWS(y, h);
+
+  // both pixels of a byte are written at once, unless the result depends on the first one
+  uint8_t *p = &displayBuf[ y / 2 * LCD_W + x ];
+  uint8_t mask = 0;
   while (h--) {
     if (pat & 1) {
-      lcd_plot(x, y, att);
-      pat = (pat >> 1) | 0x80;
+      mask |= PIXEL_GREY_MASK(y, att);
     }
-    else {
-      pat = pat >> 1;
+    pat = (pat >> 1) | (pat << 7);
+    if ((y & 1) || h == 0 || (att & FILL_WHITE)) {
+      if (mask) {
+        lcd_mask(p, mask, att);
+        mask = 0;
+      }
+      if (y & 1) {
+        p += LCD_W;
+      }
     }
     y++;
   }
@@ -1065,6 +1340,7 @@ void lcd_vlineStip(coord_t x, scoord_t y, scoord_t h, uint8_t pat, LcdFlags att)
 void lcd_invert_line(int8_t line)
 {
   uint8_t *p  = &displayBuf[line * 4 * LCD_W];
+  LCD_DIRTY_ROWS(line * FH, FH);
   for (coord_t x=0; x<LCD_W*4; x++) {
     ASSERT_IN_DISPLAY(p);
     *p++ ^= 0xff;
@@ -1105,6 +1381,10 @@ void lcd_bmp(coord_t x, coord_t y, const uint8_t * img, coord_t offset, coord_t
   }
   uint8_t rows = (*q++ + 1) / 2;
 
+  if (y >= 0 && y < LCD_H) {
+    LCD_DIRTY_ROWS(y, min<coord_t>(2*rows+1, LCD_H-y));
+  }
+
   for (uint8_t row=0; row<rows; row++) {
     q = img + 2 + row*w + offset;
     uint8_t *p = &displayBuf[(row + (y/2)) * LCD_W + x];
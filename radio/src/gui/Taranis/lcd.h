@@ -142,6 +142,45 @@ extern coord_t lcdNextPos;
 #define DISPLAY_END            (displayBuf + DISPLAY_BUF_SIZE)
 #define ASSERT_IN_DISPLAY(p)   assert((p) >= displayBuf && (p) < DISPLAY_END)
 
+// A page is one line of displayBuf (2 pixel rows), the primitives mark the pages they write
+// and lcdRefresh() only sends the pages whose content changed since the previous refresh
+#define LCD_PAGES              (LCD_H/2)
+#define LCD_ALL_PAGES          0xFFFFFFFF
+#define LCD_FULL_REFRESH_PERIOD 50 // the whole display is sent again once in a while anyway
+extern uint32_t lcdDirtyPages;
+// rows y to y+h-1, already clipped to the display, h > 0
+#define LCD_DIRTY_ROWS(y, h)   (lcdDirtyPages |= ((LCD_ALL_PAGES >> (LCD_PAGES - ((h)+((y)&1)+1)/2)) << ((y)/2)))
+#define LCD_DIRTY_ROW(y)       (lcdDirtyPages |= (1 << ((y)/2)))
+uint32_t lcdGetChangedPages();
+void lcdInvalidatePages();
+
+#if !defined(BOOT)
+// the glyphs of the standard, SMLSIZE and TINSIZE fonts are kept expanded for each combination
+// of attributes, 32 x 92 bytes of RAM
+#define GLYPH_CACHE_SIZE       32
+#define GLYPH_MAX_HEIGHT       7
+#define GLYPH_MAX_COLS         8
+#define GLYPH_MAX_PAGES        5
+struct GlyphCacheEntry {
+  const uint8_t * pattern;
+  uint32_t key;
+  uint8_t cols;
+  uint8_t pages;
+  uint8_t advance;
+  uint8_t touch[GLYPH_MAX_PAGES][GLYPH_MAX_COLS];
+  uint8_t value[GLYPH_MAX_PAGES][GLYPH_MAX_COLS];
+};
+struct GlyphCacheStats {
+  uint32_t hits;
+  uint32_t misses;
+  uint8_t used;
+};
+extern GlyphCacheStats glyphCacheStats;
+extern bool glyphCacheEnabled;
+void glyphCacheReset();
+#define GLYPH_CACHE_HIT_RATE() (glyphCacheStats.hits + glyphCacheStats.misses ? (100 * (uint64_t)glyphCacheStats.hits) / (glyphCacheStats.hits + glyphCacheStats.misses) : 0)
+#endif
+
 #if defined(BOOT)
 // TODO quick & dirty :(
 typedef const unsigned char pm_uchar;
@@ -238,6 +277,31 @@ void lcdSetContrast();
 #endif
 
 const char *bmpLoad(uint8_t *dest, const char *filename, const unsigned int width, const unsigned int height);
+
+// Decoded bitmaps cache, keyed by the path and the size / date / time of the file
+// 2048 + 8 x 24 bytes of RAM, the bitmaps which don't fit are decoded at each use as before
+#define BITMAP_CACHE_SIZE          2048
+#define BITMAP_CACHE_ENTRIES       8
+#define BITMAP_CACHE_HOLD_MAX      (BITMAP_CACHE_SIZE - MODEL_BITMAP_SIZE - sizeof(BITMAPS_PATH "/xxxxxxxxxx.bmp"))
+#define BITMAP_CACHE_CHECK_PERIOD  100 // 1s between two checks of the file on the SD card
+struct BitmapCacheEntry {
+  uint16_t offset;
+  uint16_t size;
+  uint16_t id;
+  uint16_t lastUse;
+  tmr10ms_t lastCheck;
+  uint32_t fsize;
+  uint16_t fdate;
+  uint16_t ftime;
+  uint8_t holds;
+  bool stale;
+};
+void bmpCacheReset();
+uint16_t bmpCacheLoad(const char * filename, const unsigned int width, const unsigned int height);
+const uint8_t * bmpCacheGet(uint16_t id);
+bool bmpCacheHold(uint16_t id);
+void bmpCacheRelease(uint16_t id);
+void bmpCacheReleaseAll();
 const char *writeScreenshot();
 
 #if defined(BOOT)
@@ -111,6 +111,7 @@ void displayPresetChoice(uint8_t event)
       for (int i=0; i<3+crv.points; i++)
         points[crv.points+i] = -100 + ((i+1)*200) / (4+crv.points);
     }
+    invalidateCurveTable(s_curveChan);
   }
 }
 
@@ -124,6 +125,7 @@ void onCurveOneMenu(const char *result)
     int8_t * points = curveAddress(s_curveChan);
     for (int i=0; i<5+crv.points; i++)
       points[i] = -points[i];
+    invalidateCurveTable(s_curveChan);
   }
   else if (result == STR_CLEAR) {
     CurveInfo & crv = g_model.curves[s_curveChan];
@@ -134,6 +136,7 @@ void onCurveOneMenu(const char *result)
       for (int i=0; i<3+crv.points; i++)
         points[crv.points+i] = -100 + ((i+1)*200) / (4+crv.points);
     }
+    invalidateCurveTable(s_curveChan);
   }
 }
 
@@ -256,6 +259,10 @@ void menuModelCurveOne(uint8_t event)
         pointsOfs = i-6;
     }
   }
+
+  if (event) {
+    invalidateCurveTable(s_curveChan); // the curve may have been edited
+  }
 }
 
 void editCurveRef(coord_t x, coord_t y, CurveRef & curve, uint8_t event, uint8_t attr)
@@ -129,14 +129,18 @@ void menuModelCustomScriptOne(uint8_t event)
 
     for (int i=0; i<scriptInputsOutputs[s_currIdx].outputsCount; i++) {
       putsMixerSource(SCRIPT_ONE_3RD_COLUMN_POS+INDENT_WIDTH, FH+1+FH+i*FH, MIXSRC_FIRST_LUA+(s_currIdx*MAX_SCRIPT_OUTPUTS)+i, 0);
-      lcd_outdezNAtt(SCRIPT_ONE_3RD_COLUMN_POS+11*FW+3, FH+1+FH+i*FH, calcRESXto1000(scriptInputsOutputs[s_currIdx].outputs[i].value), PREC1);
+      lcd_outdezNAtt(SCRIPT_ONE_3RD_COLUMN_POS+11*FW+3, FH+1+FH+i*FH, calcRESXto1000(SCRIPT_OUTPUT_VALUE(s_currIdx, i)), PREC1);
     }
   }
 }
 
 void menuModelCustomScripts(uint8_t event)
 {
-  lcd_outdezAtt(19*FW, 0, luaGetMemUsed(), 0);
+  // the interpreter may be running the mix scripts
+  CoEnterMutexSection(luaMutex);
+  int memUsed = luaGetMemUsed();
+  CoLeaveMutexSection(luaMutex);
+  lcd_outdezAtt(19*FW, 0, memUsed, 0);
   lcd_puts(19*FW+1, 0, STR_BYTES);
 
   MENU(STR_MENUCUSTOMSCRIPTS, menuTabModel, e_CustomScripts, MAX_SCRIPTS, { NAVIGATION_LINE_BY_LINE|3/*repeated*/ });
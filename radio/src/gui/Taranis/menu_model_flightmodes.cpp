@@ -104,7 +104,7 @@ void menuModelFlightModesAll(uint8_t event)
           }
         }
       }
-      return;
+      break;
     }
 
     FlightModeData *p = flightModeAddress(k);
@@ -151,4 +151,12 @@ void menuModelFlightModesAll(uint8_t event)
       }
     }
   }
+
+  if (event) {
+    // the trims modes may have been edited, resolved again with the mixer paused
+    pauseMixerCalculations();
+    INVALIDATE_MIXER_PROGRAM();
+    checkFlightModesInheritance();
+    resumeMixerCalculations();
+  }
 }
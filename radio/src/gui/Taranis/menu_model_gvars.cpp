@@ -48,9 +48,13 @@ void onGVARSMenu(const char *result)
     eeDirty(EE_MODEL);
   }
   else if (result == STR_CLEAR) {
+    pauseMixerCalculations();
     for (int i=0; i<MAX_FLIGHT_MODES; i++) {
       g_model.flightModeData[i].gvars[sub] = 0;
     }
+    INVALIDATE_MIXER_PROGRAM();
+    checkFlightModesInheritance();
+    resumeMixerCalculations();
     eeDirty(EE_MODEL);
   }
 }
@@ -136,4 +140,12 @@ void menuModelGVars(uint8_t event)
     MENU_ADD_ITEM(STR_CLEAR);
     menuHandler = onGVARSMenu;
   }
+
+  if (event) {
+    // the flight modes inheritance may have been edited, resolved again with the mixer paused
+    pauseMixerCalculations();
+    INVALIDATE_MIXER_PROGRAM();
+    checkFlightModesInheritance();
+    resumeMixerCalculations();
+  }
 }
@@ -144,6 +144,7 @@ void deleteExpoMix(uint8_t expo, uint8_t idx)
     memmove(mix, mix+1, (MAX_MIXERS-(idx+1))*sizeof(MixData));
     memclear(&g_model.mixData[MAX_MIXERS-1], sizeof(MixData));
   }
+  INVALIDATE_MIXER_PROGRAM();
   resumeMixerCalculations();
   eeDirty(EE_MODEL);
 }
@@ -177,6 +178,7 @@ void insertExpoMix(uint8_t expo, uint8_t idx)
     }
     mix->weight = 100;
   }
+  INVALIDATE_MIXER_PROGRAM();
   resumeMixerCalculations();
   eeDirty(EE_MODEL);
 }
@@ -192,6 +194,7 @@ void copyExpoMix(uint8_t expo, uint8_t idx)
     MixData *mix = mixAddress(idx);
     memmove(mix+1, mix, (MAX_MIXERS-(idx+1))*sizeof(MixData));
   }
+  INVALIDATE_MIXER_PROGRAM();
   resumeMixerCalculations();
   eeDirty(EE_MODEL);
 }
@@ -209,7 +212,7 @@ void memswap(void *a, void *b, uint8_t size)
   }
 }
 
-bool swapExpoMix(uint8_t expo, uint8_t &idx, uint8_t up)
+static bool swapExpoMixLines(uint8_t expo, uint8_t &idx, uint8_t up)
 {
   void *x, *y;
   uint8_t size;
@@ -281,14 +284,22 @@ bool swapExpoMix(uint8_t expo, uint8_t &idx, uint8_t up)
     size = sizeof(MixData);
   }
 
-  pauseMixerCalculations();
   memswap(x, y, size);
-  resumeMixerCalculations();
 
   idx = tgt_idx;
   return true;
 }
 
+bool swapExpoMix(uint8_t expo, uint8_t &idx, uint8_t up)
+{
+  // the channel changes are also done with the mixer paused
+  pauseMixerCalculations();
+  bool result = swapExpoMixLines(expo, idx, up);
+  INVALIDATE_MIXER_PROGRAM();
+  resumeMixerCalculations();
+  return result;
+}
+
 enum ExposFields {
   EXPO_FIELD_INPUT_NAME,
   EXPO_FIELD_NAME,
@@ -396,6 +407,10 @@ void menuModelExpoOne(uint8_t event)
     y += FH;
   }
 
+  if (event) {
+    INVALIDATE_MIXER_PROGRAM(); // the line may have been edited
+  }
+
   DrawFunction(expoFn);
 
   int x512 = getValue(ed->srcRaw);
@@ -596,6 +611,10 @@ void menuModelMixOne(uint8_t event)
         break;
     }
   }
+
+  if (event) {
+    INVALIDATE_MIXER_PROGRAM(); // the line may have been edited
+  }
 }
 
 static uint8_t s_maxLines = 8;
@@ -84,10 +84,12 @@ void onLogicalSwitchesMenu(const char *result)
   }
   else if (result == STR_PASTE) {
     *cs = clipboard.data.csw;
+    INVALIDATE_MIXER_PROGRAM();
     eeDirty(EE_MODEL);
   }
   else if (result == STR_CLEAR) {
     memset(cs, 0, sizeof(LogicalSwitchData));
+    INVALIDATE_MIXER_PROGRAM();
     eeDirty(EE_MODEL);
   }
 }
@@ -278,4 +280,8 @@ void menuModelLogicalSwitches(uint8_t event)
       }
     }
   }
+
+  if (event) {
+    INVALIDATE_MIXER_PROGRAM(); // the switch may have been edited
+  }
 }
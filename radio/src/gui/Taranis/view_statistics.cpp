@@ -98,7 +98,7 @@ void menuStatisticsView(uint8_t event)
 #define MENU_DEBUG_Y_MIXMAX   (2*FH-3)
 #define MENU_DEBUG_Y_LUA      (3*FH-2)
 #define MENU_DEBUG_Y_FREE_RAM (4*FH-1)
-#define MENU_DEBUG_Y_STACK    (5*FH)
+#define MENU_DEBUG_Y_LATENCY  (5*FH)
 #define MENU_DEBUG_Y_RTOS     (6*FH)
 
 void menuStatisticsDebug(uint8_t event)
@@ -121,6 +121,11 @@ void menuStatisticsDebug(uint8_t event)
       maxLuaDuration = 0;
 #endif
       maxMixerDuration  = 0;
+      maxFrameLatency = 0;
+      logsBufferHighWater = 0;
+      logsDroppedRecords = 0;
+      glyphCacheStats.hits = 0;
+      glyphCacheStats.misses = 0;
       AUDIO_KEYPAD_UP();
       break;
 
@@ -131,7 +136,13 @@ void menuStatisticsDebug(uint8_t event)
 #endif
 
     case EVT_KEY_FIRST(KEY_DOWN):
+#if defined(MIXER_PROFILE)
+      chainMenu(menuMixerProfile);
+#elif defined(TASKS_PROFILE)
+      chainMenu(menuTasksProfile);
+#else
       chainMenu(menuStatisticsView);
+#endif
       break;
     case EVT_KEY_FIRST(KEY_EXIT):
       chainMenu(menuMainView);
@@ -141,6 +152,12 @@ void menuStatisticsDebug(uint8_t event)
   lcd_putsLeft(MENU_DEBUG_Y_FREE_RAM, "Free Mem");
   lcd_outdezAtt(MENU_DEBUG_COL1_OFS, MENU_DEBUG_Y_FREE_RAM, getAvailableMemory(), LEFT);
   lcd_puts(lcdLastPos, MENU_DEBUG_Y_FREE_RAM, "b");
+  lcd_putsAtt(lcdLastPos+FW, MENU_DEBUG_Y_FREE_RAM+1, "[Glyphs]", SMLSIZE);
+  lcd_outdezAtt(lcdLastPos, MENU_DEBUG_Y_FREE_RAM, glyphCacheStats.used, LEFT);
+  lcd_puts(lcdLastPos, MENU_DEBUG_Y_FREE_RAM, "/");
+  lcd_outdezAtt(lcdLastPos, MENU_DEBUG_Y_FREE_RAM, GLYPH_CACHE_SIZE, LEFT);
+  lcd_outdezAtt(lcdLastPos+FW, MENU_DEBUG_Y_FREE_RAM, GLYPH_CACHE_HIT_RATE(), LEFT);
+  lcd_puts(lcdLastPos, MENU_DEBUG_Y_FREE_RAM, "%");
 
 #if defined(LUA)
   lcd_putsLeft(MENU_DEBUG_Y_LUA, "Lua scripts");
@@ -153,6 +170,18 @@ void menuStatisticsDebug(uint8_t event)
   lcd_putsLeft(MENU_DEBUG_Y_MIXMAX, STR_TMIXMAXMS);
   lcd_outdezAtt(MENU_DEBUG_COL1_OFS, MENU_DEBUG_Y_MIXMAX, DURATION_MS_PREC2(maxMixerDuration), PREC2|LEFT);
   lcd_puts(lcdLastPos, MENU_DEBUG_Y_MIXMAX, "ms");
+  lcd_putsAtt(lcdLastPos+FW, MENU_DEBUG_Y_MIXMAX+1, "[Logs]", SMLSIZE);
+  lcd_outdezAtt(lcdLastPos, MENU_DEBUG_Y_MIXMAX, logsBufferHighWater, LEFT);
+  lcd_puts(lcdLastPos, MENU_DEBUG_Y_MIXMAX, "b");
+  lcd_putsAtt(lcdLastPos+2, MENU_DEBUG_Y_MIXMAX+1, "[Drop]", SMLSIZE);
+  lcd_outdezAtt(lcdLastPos, MENU_DEBUG_Y_MIXMAX, logsDroppedRecords, LEFT);
+
+  lcd_putsLeft(MENU_DEBUG_Y_LATENCY, "Latency");
+  lcd_putsAtt(MENU_DEBUG_COL1_OFS, MENU_DEBUG_Y_LATENCY+1, "[Last]", SMLSIZE);
+  lcd_outdezAtt(lcdLastPos, MENU_DEBUG_Y_LATENCY, DURATION_MS_PREC2(lastFrameLatency), PREC2|LEFT);
+  lcd_putsAtt(lcdLastPos+2, MENU_DEBUG_Y_LATENCY+1, "[Max]", SMLSIZE);
+  lcd_outdezAtt(lcdLastPos, MENU_DEBUG_Y_LATENCY, DURATION_MS_PREC2(maxFrameLatency), PREC2|LEFT);
+  lcd_puts(lcdLastPos, MENU_DEBUG_Y_LATENCY, "ms");
 
   lcd_putsLeft(MENU_DEBUG_Y_RTOS, STR_FREESTACKMINB);
   lcd_putsAtt(MENU_DEBUG_COL1_OFS, MENU_DEBUG_Y_RTOS+1, "[M]", SMLSIZE);
@@ -169,6 +198,123 @@ void menuStatisticsDebug(uint8_t event)
 }
 
 
+#if defined(MIXER_PROFILE)
+#define MENU_PROFILE_COL_MIN   (13*FW)
+#define MENU_PROFILE_COL_MEAN  (19*FW)
+#define MENU_PROFILE_COL_MAX   (25*FW)
+#define MENU_PROFILE_COL_HISTO (26*FW)
+#define MENU_PROFILE_LINE_H    6
+
+void menuMixerProfile(uint8_t event)
+{
+  TITLE("MIXER PROFILE [us]");
+
+  switch(event)
+  {
+    case EVT_KEY_FIRST(KEY_ENTER):
+      mixerProfileReset();
+      AUDIO_KEYPAD_UP();
+      break;
+    case EVT_KEY_FIRST(KEY_UP):
+      chainMenu(menuStatisticsDebug);
+      break;
+    case EVT_KEY_FIRST(KEY_DOWN):
+#if defined(TASKS_PROFILE)
+      chainMenu(menuTasksProfile);
+#else
+      chainMenu(menuStatisticsView);
+#endif
+      break;
+    case EVT_KEY_FIRST(KEY_EXIT):
+      chainMenu(menuMainView);
+      break;
+  }
+
+  lcd_putsAtt(MENU_PROFILE_COL_MIN-3*FW, FH, "Min", SMLSIZE);
+  lcd_putsAtt(MENU_PROFILE_COL_MEAN-4*FW, FH, "Mean", SMLSIZE);
+  lcd_putsAtt(MENU_PROFILE_COL_MAX-3*FW, FH, "Max", SMLSIZE);
+  lcd_putsAtt(MENU_PROFILE_COL_HISTO, FH, "Log2 histo", SMLSIZE);
+
+  for (uint8_t i=0; i<MIXER_STAGE_COUNT; i++) {
+    const MixerProfileStage & stage = mixerProfile[i];
+    coord_t y = 2*FH + i*MENU_PROFILE_LINE_H;
+    lcd_putsAtt(0, y, mixerProfileStageNames[i], TINSIZE);
+    lcd_outdezAtt(MENU_PROFILE_COL_MIN, y, stage.min*5, PREC1|TINSIZE);
+    lcd_outdezAtt(MENU_PROFILE_COL_MEAN, y, stage.count ? stage.sum*5/stage.count : 0, PREC1|TINSIZE);
+    lcd_outdezAtt(MENU_PROFILE_COL_MAX, y, stage.max*5, PREC1|TINSIZE);
+
+    // histogram, one bar per log2 bucket
+    uint32_t highest = 0;
+    for (uint8_t bucket=0; bucket<MIXER_PROFILE_BUCKETS; bucket++) {
+      if (stage.histogram[bucket] > highest) highest = stage.histogram[bucket];
+    }
+    if (highest) {
+      for (uint8_t bucket=0; bucket<MIXER_PROFILE_BUCKETS; bucket++) {
+        uint8_t height = (stage.histogram[bucket] * (MENU_PROFILE_LINE_H-1) + highest - 1) / highest;
+        if (height) lcd_vline(MENU_PROFILE_COL_HISTO+2*bucket, y+MENU_PROFILE_LINE_H-1-height, height);
+      }
+    }
+  }
+}
+#endif
+
+#if defined(TASKS_PROFILE)
+#define MENU_TASKS_COL_LOAD    (14*FW)
+#define MENU_TASKS_COL_STACK   (22*FW)
+#define MENU_TASKS_COL_BAR     (24*FW)
+#define MENU_TASKS_BAR_W       (LCD_W-MENU_TASKS_COL_BAR-2)
+#define MENU_TASKS_LINE_H      5
+
+void menuTasksProfile(uint8_t event)
+{
+  TITLE("TASKS PROFILE");
+
+  switch(event)
+  {
+    case EVT_KEY_FIRST(KEY_ENTER):
+      tasksProfileReset();
+      AUDIO_KEYPAD_UP();
+      break;
+    case EVT_KEY_FIRST(KEY_UP):
+#if defined(MIXER_PROFILE)
+      chainMenu(menuMixerProfile);
+#else
+      chainMenu(menuStatisticsDebug);
+#endif
+      break;
+    case EVT_KEY_FIRST(KEY_DOWN):
+      chainMenu(menuStatisticsView);
+      break;
+    case EVT_KEY_FIRST(KEY_EXIT):
+      chainMenu(menuMainView);
+      break;
+  }
+
+  lcd_putsAtt(MENU_TASKS_COL_LOAD-4*FW, FH, "Load%", SMLSIZE);
+  lcd_putsAtt(MENU_TASKS_COL_STACK-6*FW, FH, "Stack[b]", SMLSIZE);
+
+  coord_t y = 2*FH-2;
+  for (uint8_t i=0; i<TASKS_PROFILE_COUNT; i++) {
+    const TaskProfile & task = tasksProfile[i];
+    if (!task.name) {
+      continue;
+    }
+    lcd_putsAtt(0, y, task.name, TINSIZE);
+    lcd_outdezAtt(MENU_TASKS_COL_LOAD, y, task.load, PREC1|TINSIZE);
+    if (task.stack != TASKS_PROFILE_NO_STACK) {
+      lcd_outdezAtt(MENU_TASKS_COL_STACK, y, stack_free(task.stack), TINSIZE);
+    }
+    lcd_rect(MENU_TASKS_COL_BAR, y, MENU_TASKS_BAR_W+2, MENU_TASKS_LINE_H-1);
+    drawFilledRect(MENU_TASKS_COL_BAR+1, y+1, task.load * MENU_TASKS_BAR_W / 1000, MENU_TASKS_LINE_H-3);
+    y += MENU_TASKS_LINE_H;
+  }
+
+  lcd_putsAtt(0, y, "Mixer scheduling latency [Max]", TINSIZE);
+  lcd_outdezAtt(MENU_TASKS_COL_STACK, y, maxMixerSchedulingLatency*5, PREC1|TINSIZE);
+  lcd_putsAtt(lcdLastPos+1, y, "us", TINSIZE);
+}
+#endif
+
 #if defined(DEBUG_TRACE_BUFFER)
 #include "stamp-opentx.h"
 
@@ -34,6 +34,13 @@
  *
  */
 
+#if defined(CPUARM)
+extern "C" {
+#include <stdio.h>
+#include <stdarg.h>
+}
+#endif
+
 #include "opentx.h"
 #include "ff.h"
 
@@ -41,6 +48,133 @@ FIL g_oLogFile = {0};
 const pm_char * g_logError = NULL;
 uint8_t logDelay;
 
+#if defined(CPUARM)
+/*
+ * The records are queued in a RAM buffer, the logs task writes them to the file by whole
+ * sectors aligned on the sectors of the file, the card never has to read a sector back
+ * before writing it. The file is stretched by LOGS_PREALLOCATION_SIZE ahead of the writes,
+ * and truncated when closed, so that the FAT isn't updated at each cluster.
+ * A record which doesn't fit in the buffer is dropped, perMain() never waits for the card.
+ */
+#if defined(PCBTARANIS)
+  #define LOGS_BUFFER_SIZE        2048  // 4 sectors, a CSV record with all the sensors is ~400 bytes
+#else
+  #define LOGS_BUFFER_SIZE        1024
+#endif
+#define LOGS_FLUSH_SIZE           512   // the FatFs sector size
+#define LOGS_PREALLOCATION_SIZE   (64*1024)
+
+static uint8_t logsBuffer[LOGS_BUFFER_SIZE];
+static volatile uint32_t logsBufferHead = 0;  // the next byte to write to the file, file offset modulo 2^32
+static volatile uint32_t logsBufferTail = 0;  // the end of the last complete record
+static uint32_t logsBufferEnd = 0;            // the end of the record being queued
+static bool logsRecordOverflow = false;
+static volatile FRESULT logsError = FR_OK;
+uint16_t logsBufferHighWater = 0;
+uint16_t logsDroppedRecords = 0;
+
+static void logsWrite(const void * data, uint32_t size)
+{
+  if (logsRecordOverflow || logsBufferEnd + size - logsBufferHead > LOGS_BUFFER_SIZE) {
+    logsRecordOverflow = true;
+    return;
+  }
+  const uint8_t * p = (const uint8_t *)data;
+  while (size--) {
+    logsBuffer[logsBufferEnd++ % LOGS_BUFFER_SIZE] = *p++;
+  }
+}
+
+#if !defined(BINARY_LOGS)
+static int logsPrintf(const char * format, ...)
+{
+  char line[64];
+  va_list arglist;
+  va_start(arglist, format);
+  int result = vsnprintf(line, sizeof(line), format, arglist);
+  va_end(arglist);
+  if (result > 0) {
+    logsWrite(line, min<int>(result, sizeof(line)-1));
+  }
+  return result;
+}
+#endif
+
+// the record is queued once complete, or dropped if it didn't fit
+static int logsCommit()
+{
+  if (logsRecordOverflow) {
+    logsRecordOverflow = false;
+    logsBufferEnd = logsBufferTail;
+    logsDroppedRecords++;
+  }
+  else {
+    logsBufferTail = logsBufferEnd;
+  }
+
+  uint32_t count = logsBufferTail - logsBufferHead;
+  if (count > logsBufferHighWater) {
+    logsBufferHighWater = count;
+  }
+  if (count >= LOGS_FLUSH_SIZE) {
+    CoSetFlag(logsFlag);
+  }
+
+  return (logsError == FR_OK ? 0 : -1);
+}
+
+// writes the buffer up to the last sector boundary, or everything when closing the file
+static FRESULT writeLogsBuffer(bool all)
+{
+  while (1) {
+    uint32_t head = logsBufferHead;
+    uint32_t count = logsBufferTail - head;
+    uint32_t size = LOGS_FLUSH_SIZE - (head % LOGS_FLUSH_SIZE);
+    if (count < size) {
+      if (!all || count == 0)
+        return FR_OK;
+      size = count;
+    }
+
+    DWORD position = f_tell(&g_oLogFile);
+    if (position + size > f_size(&g_oLogFile)) {
+      // f_lseek() stretches the file in write mode
+      FRESULT result = f_lseek(&g_oLogFile, position + LOGS_PREALLOCATION_SIZE);
+      if (result == FR_OK)
+        result = f_lseek(&g_oLogFile, position);
+      if (result != FR_OK)
+        return result;
+    }
+
+    // the head has the same offset as the file in the sector, and the buffer holds whole sectors
+    UINT written;
+    FRESULT result = f_write(&g_oLogFile, &logsBuffer[head % LOGS_BUFFER_SIZE], size, &written);
+    if (result != FR_OK)
+      return result;
+    if (written != size)
+      return FR_DENIED; // card full
+    logsBufferHead = head + size;
+  }
+}
+
+void flushLogs()
+{
+  CoEnterMutexSection(logsMutex);
+  if (g_oLogFile.fs && logsError == FR_OK) {
+    logsError = writeLogsBuffer(false);
+  }
+  CoLeaveMutexSection(logsMutex);
+}
+
+#if !defined(BINARY_LOGS)
+  #define LOGS_PRINTF(...)        logsPrintf(__VA_ARGS__)
+  #define LOGS_PUTS(str)          logsWrite(str, strlen(str))
+#endif
+#else
+  #define LOGS_PRINTF(...)        f_printf(&g_oLogFile, __VA_ARGS__)
+  #define LOGS_PUTS(str)          f_puts(str, &g_oLogFile)
+#endif
+
 #if defined(PCBTARANIS)
   #define get2PosState(sw) (switchState(SW_ ## sw ## 0) ? -1 : 1)
 #else
@@ -49,6 +183,14 @@ uint8_t logDelay;
 
 #define get3PosState(sw) (switchState(SW_ ## sw ## 0) ? -1 : (switchState(SW_ ## sw ## 2) ? 1 : 0))
 
+#if defined(PCBTARANIS)
+  #define LOGS_INPUTS_NAMES   "Rud,Ele,Thr,Ail,S1,S2,S3,LS,RS,SA,SB,SC,SD,SE,SF,SG,SH"
+  #define LOGS_SWITCHES_COUNT 8
+#else
+  #define LOGS_INPUTS_NAMES   "Rud,Ele,Thr,Ail,P1,P2,P3,THR,RUD,ELE,3POS,AIL,GEA,TRN"
+  #define LOGS_SWITCHES_COUNT 7
+#endif
+
 const pm_char *openLogs()
 {
   // Determine and set log file filename
@@ -111,16 +253,29 @@ const pm_char *openLogs()
     return SDCARD_ERROR(result);
   }
 
-  if (f_size(&g_oLogFile) == 0) {
-    writeHeader();
-  }
-  else {
+  if (f_size(&g_oLogFile) != 0) {
     result = f_lseek(&g_oLogFile, f_size(&g_oLogFile)); // append
     if (result != FR_OK) {
       return SDCARD_ERROR(result);
     }
   }
 
+#if defined(CPUARM)
+  logsBufferHead = logsBufferTail = logsBufferEnd = f_tell(&g_oLogFile);
+#endif
+
+#if defined(BINARY_LOGS)
+  writeHeader(); // the sensors may have changed, and the next record is relative to 0
+#else
+  if (f_size(&g_oLogFile) == 0) {
+    writeHeader();
+  }
+#endif
+
+#if defined(CPUARM)
+  logsCommit();
+#endif
+
   return NULL;
 }
 
@@ -128,10 +283,29 @@ tmr10ms_t lastLogTime = 0;
 
 void closeLogs()
 {
+#if defined(CPUARM)
+  CoEnterMutexSection(logsMutex);
+  if (g_oLogFile.fs) {
+    if (logsError == FR_OK) {
+      logsError = writeLogsBuffer(true);
+    }
+    if (logsError != FR_OK) {
+      // back to the end of the last sector written, the file pointer may be anywhere after a failed write
+      f_lseek(&g_oLogFile, logsBufferHead);
+    }
+    f_truncate(&g_oLogFile); // the preallocated clusters are released, also after a write error
+  }
+  logsBufferHead = logsBufferTail = logsBufferEnd = 0;
+  logsRecordOverflow = false;
+  logsError = FR_OK;
+#endif
   if (f_close(&g_oLogFile) != FR_OK) {
     // close failed, forget file
     g_oLogFile.fs = 0;
   }
+#if defined(CPUARM)
+  CoLeaveMutexSection(logsMutex);
+#endif
   lastLogTime = 0;
 }
 
@@ -143,27 +317,226 @@ getvalue_t getConvertedTelemetryValue(getvalue_t val, uint8_t unit)
 }
 #endif
 
+#if defined(RTCLOCK)
+// the date is only converted again when the RTC time changes
+static struct gtm * getLogsTime()
+{
+  static struct gtm utm;
+  static gtime_t lastRtcTime = 0;
+  if (g_rtcTime != lastRtcTime) {
+    lastRtcTime = g_rtcTime;
+    gettime(&utm);
+  }
+  return &utm;
+}
+#endif
+
+#if defined(BINARY_LOGS)
+/*
+ * Binary logs: a header describing the columns, then one record per log period
+ *
+ *   header: "OTXL", version, number of columns, then for each column its format,
+ *           its precision, its name and its unit (both zero terminated)
+ *   record: 'R', then each value as the difference with the same value in the
+ *           previous record, zigzag and LEB128 encoded
+ *
+ * GPS columns hold 2 values, the longitude and the latitude (ddmm.mmmm * 10000 + 1,
+ * negative towards W / S), so do the date-time ones (yyyymmdd and hhmmss), 0 meaning
+ * no value yet. A header is written each time the file is opened and after a dropped
+ * record, the first record after it is relative to 0. radio/util/logs2csv.py converts these logs to CSV.
+ */
+
+#define LOGS_MAGIC          "OTXL"
+#define LOGS_VERSION        1
+#define LOGS_RECORD         'R'
+
+enum LogsColumnFormat {
+  LOGS_COLUMN_VALUE,
+  LOGS_COLUMN_DATE,     // yyyymmdd
+  LOGS_COLUMN_TIME,     // 10ms since midnight, or since the start without RTC
+  LOGS_COLUMN_GPS,
+  LOGS_COLUMN_DATETIME,
+};
+
+#define LOGS_MAX_VALUES     (2 + 2*MAX_SENSORS + NUM_STICKS+NUM_POTS + LOGS_SWITCHES_COUNT)
+
+static int32_t logsValues[LOGS_MAX_VALUES]; // the values of the previous record
+static bool logsValuesLost = false;          // a record has been dropped, logsValues don't match the file any more
+
+static void writeLogsColumn(uint8_t format, uint8_t prec, const char * name, uint8_t len, const char * unit=NULL)
+{
+  uint8_t column[2 + 8+1 + 3+1];
+  uint8_t * p = column;
+  *p++ = format;
+  *p++ = prec;
+  for (uint8_t i=0; i<len && i<8 && name[i]; i++) {
+    *p++ = name[i];
+  }
+  *p++ = '\0';
+  for (uint8_t i=0; unit && i<3 && unit[i]; i++) {
+    *p++ = unit[i];
+  }
+  *p++ = '\0';
+  logsWrite(column, p-column);
+}
+
 void writeHeader()
 {
+  uint8_t header[sizeof(LOGS_MAGIC)+1];
+  memcpy(header, LOGS_MAGIC, sizeof(LOGS_MAGIC)-1);
+  header[sizeof(LOGS_MAGIC)-1] = LOGS_VERSION;
 #if defined(RTCLOCK)
-  f_puts("Date,Time,", &g_oLogFile);
+  header[sizeof(LOGS_MAGIC)] = 2 + NUM_STICKS+NUM_POTS + LOGS_SWITCHES_COUNT;
 #else
-  f_puts("Time,", &g_oLogFile);
+  header[sizeof(LOGS_MAGIC)] = 1 + NUM_STICKS+NUM_POTS + LOGS_SWITCHES_COUNT;
+#endif
+#if defined(FRSKY)
+  for (int i=0; i<MAX_SENSORS; i++) {
+    if (g_model.telemetrySensors[i].logs) {
+      header[sizeof(LOGS_MAGIC)]++;
+    }
+  }
+#endif
+  logsWrite(header, sizeof(header));
+
+#if defined(RTCLOCK)
+  writeLogsColumn(LOGS_COLUMN_DATE, 0, "Date", 4);
+#endif
+  writeLogsColumn(LOGS_COLUMN_TIME, 0, "Time", 4);
+
+#if defined(FRSKY)
+  char label[TELEM_LABEL_LEN+1];
+  for (int i=0; i<MAX_SENSORS; i++) {
+    TelemetrySensor & sensor = g_model.telemetrySensors[i];
+    if (sensor.logs) {
+      memset(label, 0, sizeof(label));
+      zchar2str(label, sensor.label, TELEM_LABEL_LEN);
+      if (sensor.unit == UNIT_GPS)
+        writeLogsColumn(LOGS_COLUMN_GPS, 0, label, TELEM_LABEL_LEN);
+      else if (sensor.unit == UNIT_DATETIME)
+        writeLogsColumn(LOGS_COLUMN_DATETIME, 0, label, TELEM_LABEL_LEN);
+      else
+        writeLogsColumn(LOGS_COLUMN_VALUE, sensor.prec, label, TELEM_LABEL_LEN, sensor.unit == UNIT_RAW ? NULL : STR_VTELEMUNIT+1+3*sensor.unit);
+    }
+  }
+#endif
+
+  const char * name = LOGS_INPUTS_NAMES;
+  for (uint8_t i=0; i<NUM_STICKS+NUM_POTS+LOGS_SWITCHES_COUNT; i++) {
+    const char * end = name;
+    while (*end && *end != ',') end++;
+    writeLogsColumn(LOGS_COLUMN_VALUE, 0, name, end-name);
+    name = (*end ? end+1 : end);
+  }
+
+  memclear(logsValues, sizeof(logsValues));
+  logsValuesLost = false;
+}
+
+static void writeLogsValue(int32_t * previous, int32_t value)
+{
+  uint8_t buf[5];
+  uint8_t * p = buf;
+  uint32_t delta = (uint32_t)value - (uint32_t)*previous;
+  uint32_t zigzag = (delta << 1) ^ (uint32_t)((int32_t)delta >> 31);
+  *previous = value;
+  while (zigzag >= 0x80) {
+    *p++ = (zigzag & 0x7F) | 0x80;
+    zigzag >>= 7;
+  }
+  *p++ = zigzag;
+  logsWrite(buf, p-buf);
+}
+
+#if defined(FRSKY)
+static int32_t getLogsGpsValue(uint16_t bp, uint16_t ap, char direction, char negative)
+{
+  if (!direction)
+    return 0;
+  int32_t value = (int32_t)bp*10000 + ap + 1;
+  return direction == negative ? -value : value;
+}
+#endif
+
+static int writeLogsRecord(tmr10ms_t tmr10ms)
+{
+  if (logsValuesLost) {
+    // the values are encoded in place, the next record after a dropped one starts again from a header
+    writeHeader();
+  }
+
+  int32_t * previous = logsValues;
+  const uint8_t record = LOGS_RECORD;
+  logsWrite(&record, 1);
+
+#if defined(RTCLOCK)
+  struct gtm * utm = getLogsTime();
+  writeLogsValue(previous++, (utm->tm_year+1900)*10000 + (utm->tm_mon+1)*100 + utm->tm_mday);
+  writeLogsValue(previous++, ((utm->tm_hour*60 + utm->tm_min)*60 + utm->tm_sec)*100 + g_ms100);
+#else
+  writeLogsValue(previous++, tmr10ms);
+#endif
+
+#if defined(FRSKY)
+  for (int i=0; i<MAX_SENSORS; i++) {
+    TelemetrySensor & sensor = g_model.telemetrySensors[i];
+    TelemetryItem & telemetryItem = telemetryItems[i];
+    if (sensor.logs) {
+      if (sensor.unit == UNIT_GPS) {
+        bool valid = (telemetryItem.gps.longitudeEW && telemetryItem.gps.latitudeNS);
+        writeLogsValue(previous++, valid ? getLogsGpsValue(telemetryItem.gps.longitude_bp, telemetryItem.gps.longitude_ap, telemetryItem.gps.longitudeEW, 'W') : 0);
+        writeLogsValue(previous++, valid ? getLogsGpsValue(telemetryItem.gps.latitude_bp, telemetryItem.gps.latitude_ap, telemetryItem.gps.latitudeNS, 'S') : 0);
+      }
+      else if (sensor.unit == UNIT_DATETIME) {
+        bool valid = telemetryItem.datetime.datestate;
+        writeLogsValue(previous++, valid ? (int32_t)telemetryItem.datetime.year*10000 + telemetryItem.datetime.month*100 + telemetryItem.datetime.day : 0);
+        writeLogsValue(previous++, valid ? (int32_t)telemetryItem.datetime.hour*10000 + telemetryItem.datetime.min*100 + telemetryItem.datetime.sec : 0);
+      }
+      else {
+        writeLogsValue(previous++, telemetryItem.value);
+      }
+    }
+  }
+#endif
+
+  for (uint8_t i=0; i<NUM_STICKS+NUM_POTS; i++) {
+    writeLogsValue(previous++, calibratedStick[i]);
+  }
+
+#if defined(PCBTARANIS)
+  int32_t switches[LOGS_SWITCHES_COUNT] = { get3PosState(SA), get3PosState(SB), get3PosState(SC), get3PosState(SD), get3PosState(SE), get2PosState(SF), get3PosState(SG), get2PosState(SH) };
+#else
+  int32_t switches[LOGS_SWITCHES_COUNT] = { get2PosState(THR), get2PosState(RUD), get2PosState(ELE), get3PosState(ID), get2PosState(AIL), get2PosState(GEA), get2PosState(TRN) };
+#endif
+  for (uint8_t i=0; i<LOGS_SWITCHES_COUNT; i++) {
+    writeLogsValue(previous++, switches[i]);
+  }
+
+  logsValuesLost = logsRecordOverflow;
+  return 0;
+}
+#else
+void writeHeader()
+{
+#if defined(RTCLOCK)
+  LOGS_PUTS("Date,Time,");
+#else
+  LOGS_PUTS("Time,");
 #endif
 
 #if defined(FRSKY)
 #if !defined(CPUARM)
-  f_puts("Buffer,RX,TX,A1,A2,", &g_oLogFile);
+  LOGS_PUTS("Buffer,RX,TX,A1,A2,");
 #if defined(FRSKY_HUB)
   if (IS_USR_PROTO_FRSKY_HUB()) {
-    f_puts("GPS Date,GPS Time,Long,Lat,Course,GPS Speed(kts),GPS Alt,Baro Alt(", &g_oLogFile);
-    f_puts(TELEMETRY_BARO_ALT_UNIT, &g_oLogFile);
-    f_puts("),Vertical Speed,Air Speed(kts),Temp1,Temp2,RPM,Fuel," TELEMETRY_CELLS_LABEL "Current,Consumption,Vfas,AccelX,AccelY,AccelZ,", &g_oLogFile);
+    LOGS_PUTS("GPS Date,GPS Time,Long,Lat,Course,GPS Speed(kts),GPS Alt,Baro Alt(");
+    LOGS_PUTS(TELEMETRY_BARO_ALT_UNIT);
+    LOGS_PUTS("),Vertical Speed,Air Speed(kts),Temp1,Temp2,RPM,Fuel," TELEMETRY_CELLS_LABEL "Current,Consumption,Vfas,AccelX,AccelY,AccelZ,");
   }
 #endif
 #if defined(WS_HOW_HIGH)
   if (IS_USR_PROTO_WS_HOW_HIGH()) {
-    f_puts("WSHH Alt,", &g_oLogFile);
+    LOGS_PUTS("WSHH Alt,");
   }
 #endif
 #endif
@@ -181,18 +554,15 @@ void writeHeader()
         strcat(label, ")");
       }
       strcat(label, ",");
-      f_puts(label, &g_oLogFile);
+      LOGS_PUTS(label);
     }
   }
 #endif
 #endif
 
-#if defined(PCBTARANIS)
-  f_puts("Rud,Ele,Thr,Ail,S1,S2,S3,LS,RS,SA,SB,SC,SD,SE,SF,SG,SH\n", &g_oLogFile);
-#else
-  f_puts("Rud,Ele,Thr,Ail,P1,P2,P3,THR,RUD,ELE,3POS,AIL,GEA,TRN\n", &g_oLogFile);
-#endif
+  LOGS_PUTS(LOGS_INPUTS_NAMES "\n");
 }
+#endif
 
 void writeLogs()
 {
@@ -204,7 +574,13 @@ void writeLogs()
       lastLogTime = tmr10ms;
 
       if (!g_oLogFile.fs) {
+#if defined(CPUARM)
+        CoEnterMutexSection(logsMutex);
+        const pm_char * result = openLogs();
+        CoLeaveMutexSection(logsMutex);
+#else
         const pm_char * result = openLogs();
+#endif
         if (result != NULL) {
           if (result != error_displayed) {
             error_displayed = result;
@@ -214,34 +590,31 @@ void writeLogs()
         }
       }
 
+#if defined(BINARY_LOGS)
+      int result = writeLogsRecord(tmr10ms);
+#else
 #if defined(RTCLOCK)
       {
-        static struct gtm utm;
-        static gtime_t lastRtcTime = 0;
-        if ( g_rtcTime != lastRtcTime )
-        {
-          lastRtcTime = g_rtcTime;
-          gettime(&utm);
-        }
-        f_printf(&g_oLogFile, "%4d-%02d-%02d,%02d:%02d:%02d.%02d0,", utm.tm_year+1900, utm.tm_mon+1, utm.tm_mday, utm.tm_hour, utm.tm_min, utm.tm_sec, g_ms100);
+        struct gtm * utm = getLogsTime();
+        LOGS_PRINTF("%4d-%02d-%02d,%02d:%02d:%02d.%02d0,", utm->tm_year+1900, utm->tm_mon+1, utm->tm_mday, utm->tm_hour, utm->tm_min, utm->tm_sec, g_ms100);
       }
 #else
-      f_printf(&g_oLogFile, "%d,", tmr10ms);
+      LOGS_PRINTF("%d,", tmr10ms);
 #endif
 
 #if defined(FRSKY)
 #if !defined(CPUARM)
-      f_printf(&g_oLogFile, "%d,%d,%d,", frskyStreaming, RAW_FRSKY_MINMAX(frskyData.rssi[0]), RAW_FRSKY_MINMAX(frskyData.rssi[1]));
+      LOGS_PRINTF("%d,%d,%d,", frskyStreaming, RAW_FRSKY_MINMAX(frskyData.rssi[0]), RAW_FRSKY_MINMAX(frskyData.rssi[1]));
       for (uint8_t i=0; i<MAX_FRSKY_A_CHANNELS; i++) {
         int16_t converted_value = applyChannelRatio(i, RAW_FRSKY_MINMAX(frskyData.analog[i]));
-        f_printf(&g_oLogFile, "%d.%02d,", converted_value/100, converted_value%100);
+        LOGS_PRINTF("%d.%02d,", converted_value/100, converted_value%100);
       }
 
 #if defined(FRSKY_HUB)
       TELEMETRY_BARO_ALT_PREPARE();
 
       if (IS_USR_PROTO_FRSKY_HUB()) {
-        f_printf(&g_oLogFile, "%4d-%02d-%02d,%02d:%02d:%02d,%03d.%04d%c,%03d.%04d%c,%03d.%02d," TELEMETRY_GPS_SPEED_FORMAT TELEMETRY_GPS_ALT_FORMAT TELEMETRY_BARO_ALT_FORMAT TELEMETRY_VSPEED_FORMAT TELEMETRY_ASPEED_FORMAT "%d,%d,%d,%d," TELEMETRY_CELLS_FORMAT TELEMETRY_CURRENT_FORMAT "%d," TELEMETRY_VFAS_FORMAT "%d,%d,%d,",
+        LOGS_PRINTF("%4d-%02d-%02d,%02d:%02d:%02d,%03d.%04d%c,%03d.%04d%c,%03d.%02d," TELEMETRY_GPS_SPEED_FORMAT TELEMETRY_GPS_ALT_FORMAT TELEMETRY_BARO_ALT_FORMAT TELEMETRY_VSPEED_FORMAT TELEMETRY_ASPEED_FORMAT "%d,%d,%d,%d," TELEMETRY_CELLS_FORMAT TELEMETRY_CURRENT_FORMAT "%d," TELEMETRY_VFAS_FORMAT "%d,%d,%d,",
             frskyData.hub.year+2000,
             frskyData.hub.month,
             frskyData.hub.day,
@@ -277,7 +650,7 @@ void writeLogs()
 
 #if defined(WS_HOW_HIGH)
       if (IS_USR_PROTO_WS_HOW_HIGH()) {
-        f_printf(&g_oLogFile, "%d,", TELEMETRY_RELATIVE_BARO_ALT_BP);
+        LOGS_PRINTF("%d,", TELEMETRY_RELATIVE_BARO_ALT_BP);
       }
 #endif
 #endif
@@ -289,28 +662,28 @@ void writeLogs()
         if (sensor.logs) {
           if (sensor.unit == UNIT_GPS) {
             if (telemetryItem.gps.longitudeEW && telemetryItem.gps.latitudeNS)
-              f_printf(&g_oLogFile, "%03d.%04d%c %03d.%04d%c,", telemetryItem.gps.longitude_bp, telemetryItem.gps.longitude_ap, telemetryItem.gps.longitudeEW, telemetryItem.gps.latitude_bp, telemetryItem.gps.latitude_ap, telemetryItem.gps.latitudeNS);
+              LOGS_PRINTF("%03d.%04d%c %03d.%04d%c,", telemetryItem.gps.longitude_bp, telemetryItem.gps.longitude_ap, telemetryItem.gps.longitudeEW, telemetryItem.gps.latitude_bp, telemetryItem.gps.latitude_ap, telemetryItem.gps.latitudeNS);
             else
-              f_printf(&g_oLogFile, ",");
+              LOGS_PRINTF(",");
           }
           else if (sensor.unit == UNIT_DATETIME) {
             if (telemetryItem.datetime.datestate)
-              f_printf(&g_oLogFile, "%4d-%02d-%02d %02d:%02d:%02d,", telemetryItem.datetime.year, telemetryItem.datetime.month, telemetryItem.datetime.day, telemetryItem.datetime.hour, telemetryItem.datetime.min, telemetryItem.datetime.sec);
+              LOGS_PRINTF("%4d-%02d-%02d %02d:%02d:%02d,", telemetryItem.datetime.year, telemetryItem.datetime.month, telemetryItem.datetime.day, telemetryItem.datetime.hour, telemetryItem.datetime.min, telemetryItem.datetime.sec);
             else
-              f_printf(&g_oLogFile, ",");
+              LOGS_PRINTF(",");
           }
           else if (sensor.prec == 2) {
             div_t qr = div(telemetryItem.value, 100);
-            if (telemetryItem.value < 0) f_printf(&g_oLogFile, "-");
-            f_printf(&g_oLogFile, "%d.%02d,", abs(qr.quot), abs(qr.rem));
+            if (telemetryItem.value < 0) LOGS_PRINTF("-");
+            LOGS_PRINTF("%d.%02d,", abs(qr.quot), abs(qr.rem));
           }
           else if (sensor.prec == 1) {
             div_t qr = div(telemetryItem.value, 10);
-            if (telemetryItem.value < 0) f_printf(&g_oLogFile, "-");
-            f_printf(&g_oLogFile, "%d.%d,", abs(qr.quot), abs(qr.rem));
+            if (telemetryItem.value < 0) LOGS_PRINTF("-");
+            LOGS_PRINTF("%d.%d,", abs(qr.quot), abs(qr.rem));
           }
           else {
-            f_printf(&g_oLogFile, "%d,", telemetryItem.value);
+            LOGS_PRINTF("%d,", telemetryItem.value);
           }
         }
       }
@@ -318,11 +691,11 @@ void writeLogs()
 #endif
 
       for (uint8_t i=0; i<NUM_STICKS+NUM_POTS; i++) {
-        f_printf(&g_oLogFile, "%d,", calibratedStick[i]);
+        LOGS_PRINTF("%d,", calibratedStick[i]);
       }
 
 #if defined(PCBTARANIS)
-      int result = f_printf(&g_oLogFile, "%d,%d,%d,%d,%d,%d,%d,%d\n",
+      int result = LOGS_PRINTF("%d,%d,%d,%d,%d,%d,%d,%d\n",
           get3PosState(SA),
           get3PosState(SB),
           get3PosState(SC),
@@ -332,7 +705,7 @@ void writeLogs()
           get3PosState(SG),
           get2PosState(SH));
 #else
-      int result = f_printf(&g_oLogFile, "%d,%d,%d,%d,%d,%d,%d\n",
+      int result = LOGS_PRINTF("%d,%d,%d,%d,%d,%d,%d\n",
           get2PosState(THR),
           get2PosState(RUD),
           get2PosState(ELE),
@@ -341,6 +714,11 @@ void writeLogs()
           get2PosState(GEA),
           get2PosState(TRN));
 #endif
+#endif
+
+#if defined(CPUARM)
+      result = logsCommit();
+#endif
 
       if (result<0 && !error_displayed) {
         error_displayed = STR_SDCARD_ERROR;
@@ -70,15 +70,23 @@ uint8_t luaState = 0;
 uint8_t luaScriptsCount = 0;
 ScriptInternalData scriptInternalData[MAX_SCRIPTS] = { { SCRIPT_NOFILE, 0 } };
 ScriptInputsOutputs scriptInputsOutputs[MAX_SCRIPTS] = { {0} };
+int16_t scriptOutputs[2][MAX_SCRIPTS][MAX_SCRIPT_OUTPUTS] = { { {0} } };
+uint8_t scriptOutputsFront = 0;
 ScriptInternalData standaloneScript = { SCRIPT_NOFILE, 0 };
 uint16_t maxLuaInterval = 0;
 uint16_t maxLuaDuration = 0;
 bool luaLcdAllowed;
+static bool luaMixSlot;
 
 #define PERMANENT_SCRIPTS_MAX_INSTRUCTIONS (10000/100)
+#define MIX_SCRIPTS_MAX_INSTRUCTIONS       (10000/100)
 #define MANUAL_SCRIPTS_MAX_INSTRUCTIONS    (20000/100)
 #define SET_LUA_INSTRUCTIONS_COUNT(x)      (instructionsPercent=0, lua_sethook(L, hook, LUA_MASKCOUNT, x))
 
+// the interpreter is shared between the menus task and the Lua mix scripts task
+#define LUA_LOCK()                         CoEnterMutexSection(luaMutex)
+#define LUA_UNLOCK()                       CoLeaveMutexSection(luaMutex)
+
 struct our_longjmp * global_lj = 0;
 
 /* custom panic handler */
@@ -474,12 +482,50 @@ static int luaLcdDrawPixmap(lua_State *L)
   if (!luaLcdAllowed) return 0;
   int x = luaL_checkinteger(L, 1);
   int y = luaL_checkinteger(L, 2);
+  // the bitmap is given either by a handle from lcd.loadPixmap() or by its path, width max is LCD_W/2 pixels
+  if (lua_type(L, 3) == LUA_TNUMBER) {
+    const uint8_t * bitmap = bmpCacheGet(luaL_checkunsigned(L, 3));
+    if (bitmap) {
+      lcd_bmp(x, y, bitmap);
+    }
+    return 0;
+  }
   const char * filename = luaL_checkstring(L, 3);
-  uint8_t bitmap[BITMAP_BUFFER_SIZE(LCD_W/2, LCD_H)]; // width max is LCD_W/2 pixels for saving stack and avoid a malloc here
-  const pm_char * error = bmpLoad(bitmap, filename, LCD_W/2, LCD_H);
-  if (!error) {
+  const uint8_t * bitmap = bmpCacheGet(bmpCacheLoad(filename, LCD_W/2, LCD_H));
+  if (bitmap) {
     lcd_bmp(x, y, bitmap);
   }
+  else {
+    // too big for the cache, decoded at each call
+    uint8_t bitmap[BITMAP_BUFFER_SIZE(LCD_W/2, LCD_H)];
+    const pm_char * error = bmpLoad(bitmap, filename, LCD_W/2, LCD_H);
+    if (!error) {
+      lcd_bmp(x, y, bitmap);
+    }
+  }
+  return 0;
+}
+
+static int luaLcdLoadPixmap(lua_State *L)
+{
+  const char * filename = luaL_checkstring(L, 1);
+  // the bitmaps cache is shared with the menus, it is not available to the scripts run by the mixer
+  uint16_t id = luaMixSlot ? 0 : bmpCacheLoad(filename, LCD_W/2, LCD_H);
+  if (id && bmpCacheHold(id)) {
+    lua_pushunsigned(L, id);
+  }
+  else {
+    lua_pushnil(L);
+  }
+  return 1;
+}
+
+static int luaLcdReleasePixmap(lua_State *L)
+{
+  uint16_t id = luaL_checkunsigned(L, 1);
+  if (!luaMixSlot) {
+    bmpCacheRelease(id);
+  }
   return 0;
 }
 
@@ -812,6 +858,7 @@ static int luaModelInsertInput(lua_State *L)
         expo->swtch = luaL_checkinteger(L, -1);
       }
     }
+    INVALIDATE_MIXER_PROGRAM();
   }
 
   return 0;
@@ -835,12 +882,14 @@ static int luaModelDeleteInput(lua_State *L)
 static int luaModelDeleteInputs(lua_State *L)
 {
   clearInputs();
+  INVALIDATE_MIXER_PROGRAM();
   return 0;
 }
 
 static int luaModelDefaultInputs(lua_State *L)
 {
   defaultInputs();
+  INVALIDATE_MIXER_PROGRAM();
   return 0;
 }
 
@@ -974,6 +1023,7 @@ static int luaModelInsertMix(lua_State *L)
         mix->speedDown = luaL_checkinteger(L, -1);
       }
     }
+    INVALIDATE_MIXER_PROGRAM();
   }
 
   return 0;
@@ -997,6 +1047,7 @@ static int luaModelDeleteMix(lua_State *L)
 static int luaModelDeleteMixes(lua_State *L)
 {
   memset(g_model.mixData, 0, sizeof(g_model.mixData));
+  INVALIDATE_MIXER_PROGRAM();
   return 0;
 }
 
@@ -1052,6 +1103,7 @@ static int luaModelSetLogicalSwitch(lua_State *L)
         sw->duration = luaL_checkinteger(L, -1);
       }
     }
+    INVALIDATE_MIXER_PROGRAM();
     eeDirty(EE_MODEL);
   }
 
@@ -1249,6 +1301,7 @@ static int luaModelSetGlobalVariable(lua_State *L)
   int value = luaL_checkinteger(L, 3);
   if (phase < MAX_FLIGHT_MODES && idx < MAX_GVARS && value >= -GVAR_MAX && value <= GVAR_MAX) {
     g_model.flightModeData[phase].gvars[idx] = value;
+    INVALIDATE_MIXER_PROGRAM(); // the flight mode may have inherited the GVAR
     eeDirty(EE_MODEL);
   }
   return 0;
@@ -1493,6 +1546,8 @@ const luaL_Reg lcdLib[] = {
   { "drawSwitch", luaLcdDrawSwitch },
   { "drawSource", luaLcdDrawSource },
   { "drawPixmap", luaLcdDrawPixmap },
+  { "loadPixmap", luaLcdLoadPixmap },
+  { "releasePixmap", luaLcdReleasePixmap },
   { "drawScreenTitle", luaLcdDrawScreenTitle },
   { "drawCombobox", luaLcdDrawCombobox },
   { NULL, NULL }  /* sentinel */
@@ -1504,7 +1559,7 @@ void luaDisable()
   luaState = INTERPRETER_PANIC;
 }
 
-void luaClose()
+static void luaCloseState()
 {
   if (L) {
     PROTECT_LUA() {
@@ -1516,9 +1571,18 @@ void luaClose()
     }
     UNPROTECT_LUA();
     L = NULL;
+    // the handles held by the scripts are gone with them
+    bmpCacheReleaseAll();
   }
 }
 
+void luaClose()
+{
+  LUA_LOCK();
+  luaCloseState();
+  LUA_UNLOCK();
+}
+
 void luaRegisterAll()
 {
   // Init lua
@@ -1527,7 +1591,7 @@ void luaRegisterAll()
 
 void luaInit()
 {
-  luaClose();
+  luaCloseState();
   if (luaState != INTERPRETER_PANIC) {
 #if defined(USE_BIN_ALLOCATOR)
     L = lua_newstate(bin_l_alloc, NULL);   //we use our own allocator!
@@ -1728,6 +1792,7 @@ void luaLoadPermanentScripts()
   luaScriptsCount = 0;
   memset(scriptInternalData, 0, sizeof(scriptInternalData));
   memset(scriptInputsOutputs, 0, sizeof(scriptInputsOutputs));
+  memset(scriptOutputs, 0, sizeof(scriptOutputs));
 
   // Load model scripts
   for (int i=0; i<MAX_SCRIPTS; i++) {
@@ -1791,7 +1856,7 @@ void luaError(uint8_t error)
   }
 }
 
-void luaExec(const char *filename)
+static void luaStartStandalone(const char *filename)
 {
   luaInit();
   if (luaState != INTERPRETER_PANIC) {
@@ -1808,6 +1873,13 @@ void luaExec(const char *filename)
   }
 }
 
+void luaExec(const char *filename)
+{
+  LUA_LOCK();
+  luaStartStandalone(filename);
+  LUA_UNLOCK();
+}
+
 void luaDoOneRunStandalone(uint8_t evt)
 {
   static uint8_t luaDisplayStatistics = false;
@@ -1827,7 +1899,7 @@ void luaDoOneRunStandalone(uint8_t evt)
           char nextScript[_MAX_LFN+1];
           strncpy(nextScript, lua_tostring(L, -1), _MAX_LFN);
           nextScript[_MAX_LFN] = '\0';
-          luaExec(nextScript);
+          luaStartStandalone(nextScript);
         }
         else {
           TRACE("Script run function returned unexpected value");
@@ -1883,12 +1955,12 @@ bool luaDoOneRunPermanentScript(uint8_t evt, int i, uint32_t scriptType)
   ScriptInternalData & sid = scriptInternalData[i];
   if (sid.state != SCRIPT_OK) return false;
 
-  SET_LUA_INSTRUCTIONS_COUNT(PERMANENT_SCRIPTS_MAX_INSTRUCTIONS);
   int inputsCount = 0;
 #if defined(SIMU) || defined(DEBUG)
   const char *filename;
 #endif
   ScriptInputsOutputs * sio = NULL;
+  int16_t * outputs = NULL;
 #if SCRIPT_MIX_FIRST > 0
   if ((scriptType & RUN_MIX_SCRIPT) && (sid.reference >= SCRIPT_MIX_FIRST && sid.reference <= SCRIPT_MIX_LAST)) {
 #else
@@ -1896,10 +1968,12 @@ bool luaDoOneRunPermanentScript(uint8_t evt, int i, uint32_t scriptType)
 #endif
     ScriptData & sd = g_model.scriptsData[sid.reference-SCRIPT_MIX_FIRST];
     sio = &scriptInputsOutputs[sid.reference-SCRIPT_MIX_FIRST];
+    outputs = scriptOutputs[1-scriptOutputsFront][sid.reference-SCRIPT_MIX_FIRST];
     inputsCount = sio->inputsCount;
 #if defined(SIMU) || defined(DEBUG)
     filename = sd.file;
 #endif
+    SET_LUA_INSTRUCTIONS_COUNT(MIX_SCRIPTS_MAX_INSTRUCTIONS);
     lua_rawgeti(L, LUA_REGISTRYINDEX, sid.run);
     for (int j=0; j<sio->inputsCount; j++) {
       if (sio->inputs[j].type == 1)
@@ -1914,6 +1988,7 @@ bool luaDoOneRunPermanentScript(uint8_t evt, int i, uint32_t scriptType)
 #if defined(SIMU) || defined(DEBUG)
     filename = fn.play.name;
 #endif
+    SET_LUA_INSTRUCTIONS_COUNT(PERMANENT_SCRIPTS_MAX_INSTRUCTIONS);
     lua_rawgeti(L, LUA_REGISTRYINDEX, sid.run);
   }
   else {
@@ -1921,6 +1996,7 @@ bool luaDoOneRunPermanentScript(uint8_t evt, int i, uint32_t scriptType)
     TelemetryScriptData & script = g_model.frsky.screens[sid.reference-SCRIPT_TELEMETRY_FIRST].script;
     filename = script.file;
 #endif
+    SET_LUA_INSTRUCTIONS_COUNT(PERMANENT_SCRIPTS_MAX_INSTRUCTIONS);
     if ((scriptType & RUN_TELEM_FG_SCRIPT) && 
         (g_menuStack[0]==menuTelemetryFrsky && sid.reference==SCRIPT_TELEMETRY_FIRST+s_frsky_view)) {
       lua_rawgeti(L, LUA_REGISTRYINDEX, sid.run);
@@ -1943,7 +2019,7 @@ bool luaDoOneRunPermanentScript(uint8_t evt, int i, uint32_t scriptType)
           TRACE("Script %8s disabled", filename);
           break;
         }
-        sio->outputs[j].value = lua_tointeger(L, -1);
+        outputs[j] = lua_tointeger(L, -1);
         lua_pop(L, 1);
       }
     }
@@ -1992,7 +2068,7 @@ void luaDoGc()
   }
 }
 
-bool luaTask(uint8_t evt, uint8_t scriptType, bool allowLcdUsage)
+static bool luaDoTask(uint8_t evt, uint8_t scriptType, bool allowLcdUsage)
 {
   if (luaState == INTERPRETER_PANIC) return false;
   luaLcdAllowed = allowLcdUsage;
@@ -2038,6 +2114,55 @@ bool luaTask(uint8_t evt, uint8_t scriptType, bool allowLcdUsage)
   return scriptWasRun;
 }
 
+bool luaTask(uint8_t evt, uint8_t scriptType, bool allowLcdUsage)
+{
+  LUA_LOCK();
+  bool scriptWasRun = luaDoTask(evt, scriptType, allowLcdUsage);
+  LUA_UNLOCK();
+  return scriptWasRun;
+}
+
+bool luaMixScriptsDue()
+{
+  static tmr10ms_t lastRunTime = 0;
+  tmr10ms_t now = get_tmr10ms();
+  if ((tmr10ms_t)(now - lastRunTime) < LUA_MIX_SCRIPTS_PERIOD) {
+    return false;
+  }
+  lastRunTime = now;
+  return true;
+}
+
+void luaRunMixScripts()
+{
+  LUA_LOCK();
+
+  // the menus task owns the interpreter while it (re)loads the scripts or runs a standalone script
+  if (luaState == 0 && L) {
+    uint8_t back = 1 - scriptOutputsFront;
+    // the scripts which are not run (killed, syntax error) keep their last outputs
+    memcpy(scriptOutputs[back], scriptOutputs[scriptOutputsFront], sizeof(scriptOutputs[0]));
+    luaLcdAllowed = false;
+    luaMixSlot = true;
+    for (int i=0; i<luaScriptsCount; i++) {
+      PROTECT_LUA() {
+        luaDoOneRunPermanentScript(0, i, RUN_MIX_SCRIPT);
+      }
+      else {
+        luaDisable();
+        break;
+      }
+      UNPROTECT_LUA();
+    }
+    luaMixSlot = false;
+    // the outputs are complete before the mixer reads them
+    MEMORY_BARRIER();
+    scriptOutputsFront = back;
+  }
+
+  LUA_UNLOCK();
+}
+
 int luaGetMemUsed()
 {
   return (lua_gc(L, LUA_GCCOUNT, 0) << 10) + lua_gc(L, LUA_GCCOUNTB, 0);
@@ -55,7 +55,6 @@
   };
   struct ScriptOutput {
     const char *name;
-    int16_t value;
   };
   enum ScriptState {
     SCRIPT_OK,
@@ -93,8 +92,16 @@
   extern ScriptInternalData standaloneScript;
   extern ScriptInternalData scriptInternalData[MAX_SCRIPTS];
   extern ScriptInputsOutputs scriptInputsOutputs[MAX_SCRIPTS];
+  // the mix scripts write their outputs in the back buffer, which is published at the end
+  // of the Lua mix slot, so that the mixer always reads the outputs of one complete run
+  extern int16_t scriptOutputs[2][MAX_SCRIPTS][MAX_SCRIPT_OUTPUTS];
+  extern uint8_t scriptOutputsFront;
+  #define SCRIPT_OUTPUT_VALUE(idx, output) scriptOutputs[scriptOutputsFront][idx][output]
+  #define LUA_MIX_SCRIPTS_PERIOD 2 // 20ms
   void luaClose();
   bool luaTask(uint8_t evt, uint8_t scriptType, bool allowLcdUsage);
+  bool luaMixScriptsDue();
+  void luaRunMixScripts();
   void luaExec(const char *filename);
   int luaGetMemUsed();
   #define luaGetCpuUsed(idx) scriptInternalData[idx].instructions
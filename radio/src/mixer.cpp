@@ -58,13 +58,23 @@ uint8_t mixWarning;
 #endif
 
 int16_t calibratedStick[NUM_STICKS+NUM_POTS];
+#if defined(CPUARM)
+int16_t channelOutputsFrames[2][NUM_CHNOUT] = { {0} };
+volatile uint8_t channelOutputsFrame = 0;
+uint16_t channelOutputsTimes[2];
+#else
 int16_t channelOutputs[NUM_CHNOUT] = {0};
+#endif
 int16_t ex_chans[NUM_CHNOUT] = {0}; // Outputs (before LIMITS) of the last perMain;
 
 #if defined(HELI)
   int16_t cyc_anas[3] = {0};
 #endif
 
+#if defined(CPUARM)
+  bool fmInvariantsEvaluated = false; // during flight modes fades, once the first fading flight mode is evaluated
+#endif
+
 void applyExpos(int16_t *anas, uint8_t mode APPLY_EXPOS_EXTRA_PARAMS)
 {
 #if !defined(VIRTUALINPUTS)
@@ -82,6 +92,10 @@ void applyExpos(int16_t *anas, uint8_t mode APPLY_EXPOS_EXTRA_PARAMS)
     if (!EXPO_VALID(ed)) break; // end of list
     if (ed->chn == cur_chn)
       continue;
+#if defined(VIRTUALINPUTS)
+    if (skippedInputs & ((uint32_t)1 << ed->chn))
+      continue;
+#endif
     if (ed->flightModes & (1<<mixerCurrentFlightMode))
       continue;
     if (getSwitch(ed->swtch)) {
@@ -239,26 +253,250 @@ int16_t applyLimits(uint8_t channel, int32_t value)
 
 // TODO same naming convention than the putsMixerSource
 
-getvalue_t getValue(mixsrc_t i)
-{
-  if (i==MIXSRC_NONE) return 0;
+#if defined(CPUARM)
+// The sources are dispatched through a table built at compile time, which gives
+// the family of each source index, and one handler per family
 
+enum SourceFamily {
+  SOURCE_FAMILY_NONE,
 #if defined(VIRTUALINPUTS)
-  else if (i <= MIXSRC_LAST_INPUT) {
-    return anas[i-MIXSRC_FIRST_INPUT];
-  }
+  SOURCE_FAMILY_INPUT,
+  SOURCE_FAMILY_LUA,
 #endif
+  SOURCE_FAMILY_STICK,
+#if !defined(PCBTARANIS)
+  SOURCE_FAMILY_ROTARY_ENCODER,
+#endif
+  SOURCE_FAMILY_MAX,
+  SOURCE_FAMILY_HELI,
+  SOURCE_FAMILY_TRIM,
+  SOURCE_FAMILY_SWITCH,
+  SOURCE_FAMILY_LOGICAL_SWITCH,
+  SOURCE_FAMILY_TRAINER,
+  SOURCE_FAMILY_CHANNEL,
+  SOURCE_FAMILY_GVAR,
+  SOURCE_FAMILY_TX_VOLTAGE,
+  SOURCE_FAMILY_TX_TIME,
+  SOURCE_FAMILY_TIMER,
+  SOURCE_FAMILY_TELEMETRY,
+  SOURCE_FAMILY_COUNT
+};
+
+#if defined(VIRTUALINPUTS)
+  #define SOURCE_FAMILY_BEFORE_STICKS(i) ((i) >= MIXSRC_FIRST_LUA ? SOURCE_FAMILY_LUA : (i) >= MIXSRC_FIRST_INPUT ? SOURCE_FAMILY_INPUT : SOURCE_FAMILY_NONE)
+#else
+  #define SOURCE_FAMILY_BEFORE_STICKS(i) SOURCE_FAMILY_NONE
+#endif
+
+#if !defined(PCBTARANIS)
+  #define SOURCE_FAMILY_BEFORE_MAX(i)    ((i) > MIXSRC_LAST_POT ? SOURCE_FAMILY_ROTARY_ENCODER : (i) >= MIXSRC_FIRST_STICK ? SOURCE_FAMILY_STICK : SOURCE_FAMILY_BEFORE_STICKS(i))
+#else
+  #define SOURCE_FAMILY_BEFORE_MAX(i)    ((i) >= MIXSRC_FIRST_STICK ? SOURCE_FAMILY_STICK : SOURCE_FAMILY_BEFORE_STICKS(i))
+#endif
+
+#define SOURCE_FAMILY(i) ( \
+  (i) > MIXSRC_LAST_TELEM ? SOURCE_FAMILY_NONE : \
+  (i) >= MIXSRC_FIRST_TELEM ? SOURCE_FAMILY_TELEMETRY : \
+  (i) >= MIXSRC_FIRST_TIMER ? SOURCE_FAMILY_TIMER : \
+  (i) >= MIXSRC_TX_TIME ? SOURCE_FAMILY_TX_TIME : \
+  (i) >= MIXSRC_TX_VOLTAGE ? SOURCE_FAMILY_TX_VOLTAGE : \
+  (i) >= MIXSRC_FIRST_GVAR ? SOURCE_FAMILY_GVAR : \
+  (i) >= MIXSRC_FIRST_CH ? SOURCE_FAMILY_CHANNEL : \
+  (i) >= MIXSRC_FIRST_TRAINER ? SOURCE_FAMILY_TRAINER : \
+  (i) >= MIXSRC_FIRST_LOGICAL_SWITCH ? SOURCE_FAMILY_LOGICAL_SWITCH : \
+  (i) >= MIXSRC_FIRST_SWITCH ? SOURCE_FAMILY_SWITCH : \
+  (i) >= MIXSRC_FIRST_TRIM ? SOURCE_FAMILY_TRIM : \
+  (i) >= MIXSRC_FIRST_HELI ? SOURCE_FAMILY_HELI : \
+  (i) >= MIXSRC_MAX ? SOURCE_FAMILY_MAX : \
+  SOURCE_FAMILY_BEFORE_MAX(i))
+
+#define SOURCE_FAMILIES_4(i)   SOURCE_FAMILY(i), SOURCE_FAMILY(i+1), SOURCE_FAMILY(i+2), SOURCE_FAMILY(i+3)
+#define SOURCE_FAMILIES_16(i)  SOURCE_FAMILIES_4(i), SOURCE_FAMILIES_4(i+4), SOURCE_FAMILIES_4(i+8), SOURCE_FAMILIES_4(i+12)
+#define SOURCE_FAMILIES_64(i)  SOURCE_FAMILIES_16(i), SOURCE_FAMILIES_16(i+16), SOURCE_FAMILIES_16(i+32), SOURCE_FAMILIES_16(i+48)
+#define SOURCE_FAMILIES_COUNT  512
+
+const uint8_t sourceFamilies[SOURCE_FAMILIES_COUNT] = {
+  SOURCE_FAMILIES_64(0), SOURCE_FAMILIES_64(64), SOURCE_FAMILIES_64(128), SOURCE_FAMILIES_64(192),
+  SOURCE_FAMILIES_64(256), SOURCE_FAMILIES_64(320), SOURCE_FAMILIES_64(384), SOURCE_FAMILIES_64(448)
+};
+
+// the table must cover all the sources
+typedef char sourceFamiliesCountCheck[MIXSRC_LAST_TELEM < SOURCE_FAMILIES_COUNT ? 1 : -1];
+
+typedef getvalue_t (*SourceValueFn)(mixsrc_t i);
+
+getvalue_t getNoneSourceValue(mixsrc_t i)
+{
+  return 0;
+}
 
-#if defined(LUAINPUTS)
-  else if (i<MIXSRC_LAST_LUA) {
+#if defined(VIRTUALINPUTS)
+getvalue_t getInputSourceValue(mixsrc_t i)
+{
+  return anas[i-MIXSRC_FIRST_INPUT];
+}
+
+getvalue_t getLuaSourceValue(mixsrc_t i)
+{
 #if defined(LUA_MODEL_SCRIPTS)
-    div_t qr = div(i-MIXSRC_FIRST_LUA, MAX_SCRIPT_OUTPUTS);
-    return scriptInputsOutputs[qr.quot].outputs[qr.rem].value;
+  div_t qr = div(i-MIXSRC_FIRST_LUA, MAX_SCRIPT_OUTPUTS);
+  return SCRIPT_OUTPUT_VALUE(qr.quot, qr.rem);
+#else
+  return 0;
+#endif
+}
+#endif
+
+getvalue_t getStickSourceValue(mixsrc_t i)
+{
+  return calibratedStick[i-MIXSRC_Rud];
+}
+
+#if !defined(PCBTARANIS)
+getvalue_t getRotaryEncoderSourceValue(mixsrc_t i)
+{
+#if defined(ROTARY_ENCODERS)
+  return getRotaryEncoder(i-MIXSRC_REa);
 #else
+  return 0;
+#endif
+}
+#endif
+
+getvalue_t getMaxSourceValue(mixsrc_t i)
+{
+  return 1024;
+}
+
+getvalue_t getHeliSourceValue(mixsrc_t i)
+{
+#if defined(HELI)
+  return cyc_anas[i-MIXSRC_CYC1];
+#else
+  return 0;
+#endif
+}
+
+getvalue_t getTrimSourceValue(mixsrc_t i)
+{
+  return calc1000toRESX((int16_t)8 * getTrimValue(mixerCurrentFlightMode, i-MIXSRC_TrimRud));
+}
+
+getvalue_t getSwitchSourceValue(mixsrc_t i)
+{
+#if defined(PCBTARANIS)
+  mixsrc_t sw = i-MIXSRC_FIRST_SWITCH;
+  if (SWITCH_EXISTS(sw)) {
+    return (switchState((EnumKeys)(SW_BASE+(3*sw))) ? -1024 : (switchState((EnumKeys)(SW_BASE+(3*sw)+1)) ? 0 : 1024));
+  }
+  else {
     return 0;
+  }
+#else
+  if (i == MIXSRC_3POS)
+    return (getSwitch(SW_ID0-SW_BASE+1) ? -1024 : (getSwitch(SW_ID1-SW_BASE+1) ? 0 : 1024));
+  // don't use switchState directly to give getSwitch possibility to hack values if needed for switch warning
+  else
+    return getSwitch(SWSRC_THR+i-MIXSRC_THR) ? 1024 : -1024;
+#endif
+}
+
+getvalue_t getLogicalSwitchSourceValue(mixsrc_t i)
+{
+  return getSwitch(SWSRC_FIRST_LOGICAL_SWITCH+i-MIXSRC_FIRST_LOGICAL_SWITCH) ? 1024 : -1024;
+}
+
+getvalue_t getTrainerSourceValue(mixsrc_t i)
+{
+  int16_t x = ppmInput[i-MIXSRC_FIRST_TRAINER];
+  if (i<MIXSRC_FIRST_TRAINER+NUM_CAL_PPM) {
+    x -= g_eeGeneral.trainer.calib[i-MIXSRC_FIRST_TRAINER];
+  }
+  return x*2;
+}
+
+getvalue_t getChannelSourceValue(mixsrc_t i)
+{
+  return ex_chans[i-MIXSRC_CH1];
+}
+
+getvalue_t getGVarSourceValue(mixsrc_t i)
+{
+#if defined(GVARS)
+  return GVAR_VALUE(i-MIXSRC_GVAR1, getGVarFlightPhase(mixerCurrentFlightMode, i-MIXSRC_GVAR1));
+#else
+  return 0;
+#endif
+}
+
+getvalue_t getTxVoltageSourceValue(mixsrc_t i)
+{
+  return g_vbat100mV;
+}
+
+getvalue_t getTxTimeSourceValue(mixsrc_t i)
+{
+  // TX_TIME + SPARES
+#if defined(RTCLOCK)
+  return (g_rtcTime % SECS_PER_DAY) / 60; // number of minutes from midnight
+#else
+  return 0;
 #endif
+}
+
+getvalue_t getTimerSourceValue(mixsrc_t i)
+{
+  return timersStates[i-MIXSRC_FIRST_TIMER].val;
+}
+
+getvalue_t getTelemetrySourceValue(mixsrc_t i)
+{
+  i -= MIXSRC_FIRST_TELEM;
+  div_t qr = div(i, 3);
+  TelemetryItem & telemetryItem = telemetryItems[qr.quot];
+  switch (qr.rem) {
+    case 1:
+      return telemetryItem.valueMin;
+    case 2:
+      return telemetryItem.valueMax;
+    default:
+      return telemetryItem.value;
   }
+}
+
+const SourceValueFn sourceValueFunctions[SOURCE_FAMILY_COUNT] = {
+  getNoneSourceValue,
+#if defined(VIRTUALINPUTS)
+  getInputSourceValue,
+  getLuaSourceValue,
+#endif
+  getStickSourceValue,
+#if !defined(PCBTARANIS)
+  getRotaryEncoderSourceValue,
 #endif
+  getMaxSourceValue,
+  getHeliSourceValue,
+  getTrimSourceValue,
+  getSwitchSourceValue,
+  getLogicalSwitchSourceValue,
+  getTrainerSourceValue,
+  getChannelSourceValue,
+  getGVarSourceValue,
+  getTxVoltageSourceValue,
+  getTxTimeSourceValue,
+  getTimerSourceValue,
+  getTelemetrySourceValue
+};
+
+getvalue_t getValue(mixsrc_t i)
+{
+  if (i >= SOURCE_FAMILIES_COUNT) return 0;
+  return sourceValueFunctions[sourceFamilies[i]](i);
+}
+#else
+getvalue_t getValue(mixsrc_t i)
+{
+  if (i==MIXSRC_NONE) return 0;
 
   else if (i<=MIXSRC_LAST_POT) return calibratedStick[i-MIXSRC_Rud];
 
@@ -277,21 +515,9 @@ getvalue_t getValue(mixsrc_t i)
 
   else if (i<=MIXSRC_TrimAil) return calc1000toRESX((int16_t)8 * getTrimValue(mixerCurrentFlightMode, i-MIXSRC_TrimRud));
 
-#if defined(PCBTARANIS)
-  else if ((i >= MIXSRC_FIRST_SWITCH) && (i <= MIXSRC_LAST_SWITCH)) {
-    mixsrc_t sw = i-MIXSRC_FIRST_SWITCH;
-    if (SWITCH_EXISTS(sw)) {
-      return (switchState((EnumKeys)(SW_BASE+(3*sw))) ? -1024 : (switchState((EnumKeys)(SW_BASE+(3*sw)+1)) ? 0 : 1024));
-    }
-    else {
-      return 0;
-    }
-  }
-#else
   else if (i==MIXSRC_3POS) return (getSwitch(SW_ID0-SW_BASE+1) ? -1024 : (getSwitch(SW_ID1-SW_BASE+1) ? 0 : 1024));
   // don't use switchState directly to give getSwitch possibility to hack values if needed for switch warning
   else if (i<MIXSRC_SW1) return getSwitch(SWSRC_THR+i-MIXSRC_THR) ? 1024 : -1024;
-#endif
   else if (i<=MIXSRC_LAST_LOGICAL_SWITCH) return getSwitch(SWSRC_FIRST_LOGICAL_SWITCH+i-MIXSRC_FIRST_LOGICAL_SWITCH) ? 1024 : -1024;
   else if (i<=MIXSRC_LAST_TRAINER) { int16_t x = ppmInput[i-MIXSRC_FIRST_TRAINER]; if (i<MIXSRC_FIRST_TRAINER+NUM_CAL_PPM) { x-= g_eeGeneral.trainer.calib[i-MIXSRC_FIRST_TRAINER]; } return x*2; }
   else if (i<=MIXSRC_LAST_CH) return ex_chans[i-MIXSRC_CH1];
@@ -300,35 +526,10 @@ getvalue_t getValue(mixsrc_t i)
   else if (i<=MIXSRC_LAST_GVAR) return GVAR_VALUE(i-MIXSRC_GVAR1, getGVarFlightPhase(mixerCurrentFlightMode, i-MIXSRC_GVAR1));
 #endif
 
-#if defined(CPUARM)
-  else if (i==MIXSRC_TX_VOLTAGE) return g_vbat100mV;
-  else if (i<MIXSRC_FIRST_TIMER) // TX_TIME + SPARES
-  #if defined(RTCLOCK)
-     return (g_rtcTime % SECS_PER_DAY) / 60; // number of minutes from midnight
-  #else
-     return 0;
-  #endif
-  else if (i<=MIXSRC_LAST_TIMER) return timersStates[i-MIXSRC_FIRST_TIMER].val;
-#else
   else if (i==MIXSRC_FIRST_TELEM-1+TELEM_TX_VOLTAGE) return g_vbat100mV;
   else if (i<=MIXSRC_FIRST_TELEM-1+TELEM_TIMER2) return timersStates[i-MIXSRC_FIRST_TELEM+1-TELEM_TIMER1].val;
-#endif
 
-#if defined(CPUARM)
-  else if (i<=MIXSRC_LAST_TELEM) {
-    i -= MIXSRC_FIRST_TELEM;
-    div_t qr = div(i, 3);
-    TelemetryItem & telemetryItem = telemetryItems[qr.quot];
-    switch (qr.rem) {
-      case 1:
-        return telemetryItem.valueMin;
-      case 2:
-        return telemetryItem.valueMax;
-      default:
-        return telemetryItem.value;
-    }
-  }
-#elif defined(FRSKY)
+#if defined(FRSKY)
   else if (i==MIXSRC_FIRST_TELEM-1+TELEM_RSSI_TX) return frskyData.rssi[1].value;
   else if (i==MIXSRC_FIRST_TELEM-1+TELEM_RSSI_RX) return frskyData.rssi[0].value;
   else if (i==MIXSRC_FIRST_TELEM-1+TELEM_A1) return frskyData.analog[TELEM_ANA_A1].value;
@@ -366,6 +567,7 @@ getvalue_t getValue(mixsrc_t i)
 #endif
   else return 0;
 }
+#endif
 
 void evalInputs(uint8_t mode)
 {
@@ -492,7 +694,12 @@ void evalInputs(uint8_t mode)
   }
 
   /* EXPOs */
+#if defined(VIRTUALINPUTS) && defined(XCURVES)
+  // the flight mode invariant inputs already hold the value computed for the first flight mode
+  applyExpos(anas, mode, 0, 0, fmInvariantsEvaluated ? ~mixerProgram.fmDependentInputs : 0);
+#else
   applyExpos(anas, mode);
+#endif
 
   /* TRIMs */
   evalTrims(); // when no virtual inputs, the trims need the anas array calculated above (when throttle trim enabled)
@@ -533,12 +740,180 @@ int getSourceTrimValue(int source, int value=0)
 }
 #endif
 
+#if defined(CPUARM)
+MixerProgram mixerProgram;
+
+bool isSwitchFlightModeDependent(int8_t swtch)
+{
+  uint8_t idx = abs(swtch);
+  // physical switches, multipos switches and trims buttons are the same in all flight modes
+  return (idx > SWSRC_LAST_TRIM && idx < SWSRC_ON) || idx > SWSRC_One;
+}
+
+#if defined(XCURVES)
+bool isCurveFlightModeDependent(CurveRef & curve)
+{
+  return (curve.type == CURVE_REF_DIFF || curve.type == CURVE_REF_EXPO) && GV_IS_GV_VALUE(curve.value, -100, 100);
+}
+#endif
+
+bool isSourceFlightModeDependent(mixsrc_t src, bitfield_channels_t fmDependentChannels)
+{
+#if defined(VIRTUALINPUTS)
+  if (src >= MIXSRC_FIRST_INPUT && src <= MIXSRC_LAST_INPUT)
+    return mixerProgram.fmDependentInputs & ((uint32_t)1 << (src - MIXSRC_FIRST_INPUT));
+  if (src >= MIXSRC_FIRST_LUA && src <= MIXSRC_LAST_LUA)
+    return false;
+#else
+  if (src >= MIXSRC_Rud && src < MIXSRC_Rud+NUM_STICKS)
+    return mixerProgram.fmDependentInputs & ((uint32_t)1 << (src - MIXSRC_Rud));
+#endif
+  if (src >= MIXSRC_FIRST_CH && src <= MIXSRC_LAST_CH)
+    return fmDependentChannels & ((bitfield_channels_t)1 << (src - MIXSRC_FIRST_CH));
+  if (src <= MIXSRC_LAST_POT || src == MIXSRC_MAX)
+    return false;
+  if (src >= MIXSRC_FIRST_SWITCH && src <= MIXSRC_LAST_SWITCH)
+    return false;
+  if (src >= MIXSRC_FIRST_TRAINER && src <= MIXSRC_LAST_TRAINER)
+    return false;
+  // rotary encoders, heli, trims, logical switches and GVARs
+  return src < MIXSRC_FIRST_TIMER;
+}
+
+bool isExpoFlightModeDependent(ExpoData * ed)
+{
+  if (ed->flightModes || isSwitchFlightModeDependent(ed->swtch))
+    return true;
+  if (GV_IS_GV_VALUE(ed->weight, MIN_EXPO_WEIGHT, 100))
+    return true;
+#if defined(VIRTUALINPUTS)
+  if (GV_IS_GV_VALUE(ed->offset, -100, 100) || isCurveFlightModeDependent(ed->curve))
+    return true;
+  // inputs read the other inputs values as they are when the line is evaluated
+  if (ed->srcRaw >= MIXSRC_FIRST_INPUT && ed->srcRaw <= MIXSRC_LAST_INPUT)
+    return true;
+  return isSourceFlightModeDependent(ed->srcRaw, (bitfield_channels_t)-1);
+#else
+  return ed->curveMode != MODE_CURVE && GV_IS_GV_VALUE(ed->curveParam, -100, 100);
+#endif
+}
+
+bool isMixFlightModeDependent(MixData * md, bitfield_channels_t fmDependentChannels)
+{
+  // delays and slow-downs state is only updated in the current flight mode
+  if (md->flightModes || md->delayUp || md->delayDown || md->speedUp || md->speedDown)
+    return true;
+  if (isSwitchFlightModeDependent(md->swtch))
+    return true;
+  if (GV_IS_GV_VALUE(MD_WEIGHT(md), GV_RANGELARGE_NEG, GV_RANGELARGE) || GV_IS_GV_VALUE(MD_OFFSET(md), GV_RANGELARGE_NEG, GV_RANGELARGE))
+    return true;
+#if defined(XCURVES)
+  if (isCurveFlightModeDependent(md->curve))
+    return true;
+#else
+  if (md->curveMode == MODE_DIFFERENTIAL && GV_IS_GV_VALUE(md->curveParam, -100, 100))
+    return true;
+#endif
+  // trims are defined per flight mode
+#if defined(VIRTUALINPUTS)
+  if (md->carryTrim == 0 && ((md->srcRaw >= MIXSRC_Rud && md->srcRaw <= MIXSRC_Ail) || (md->srcRaw >= MIXSRC_FIRST_INPUT && md->srcRaw <= MIXSRC_LAST_INPUT)))
+    return true;
+#else
+  if (md->carryTrim < TRIM_ON || (md->carryTrim == TRIM_ON && md->srcRaw >= MIXSRC_Rud && md->srcRaw < MIXSRC_Rud+NUM_STICKS))
+    return true;
+#endif
+  return isSourceFlightModeDependent(md->srcRaw, fmDependentChannels);
+}
+
+void compileMixerProgram()
+{
+  bitfield_channels_t dependencies[NUM_CHNOUT];
+  uint8_t firstLine[NUM_CHNOUT];
+  bitfield_channels_t evaluated = (bitfield_channels_t)-1; // channels without mixes are already known (0)
+  uint8_t count = 0;
+
+  memclear(dependencies, sizeof(dependencies));
+  mixerProgram.count = 0;
+  mixerProgram.state = MIXER_PROGRAM_READY;
+  mixerProgram.fmDependentInputs = 0;
+  mixerProgram.fmDependentChannels = (bitfield_channels_t)-1;
+
+  for (uint8_t i=0; i<MAX_EXPOS; i++) {
+    ExpoData * ed = expoAddress(i);
+    if (!EXPO_VALID(ed)) break;
+    if (isExpoFlightModeDependent(ed)) {
+      mixerProgram.fmDependentInputs |= (uint32_t)1 << ed->chn;
+    }
+  }
+
+  for (uint8_t i=0; i<MAX_MIXERS; i++) {
+    MixData * md = mixAddress(i);
+    if (md->srcRaw == 0) break;
+    if (i > 0 && md->destCh < (md-1)->destCh) {
+      // lines not grouped by channel, keep the multi-pass evaluation
+      mixerProgram.state = MIXER_PROGRAM_CYCLIC;
+      return;
+    }
+    if (i == 0 || md->destCh != (md-1)->destCh) {
+      firstLine[md->destCh] = i;
+      evaluated &= ~((bitfield_channels_t)1 << md->destCh);
+    }
+    if (md->srcRaw >= MIXSRC_CH1 && md->srcRaw <= MIXSRC_LAST_CH && md->srcRaw-MIXSRC_CH1 != md->destCh) {
+      dependencies[md->destCh] |= (bitfield_channels_t)1 << (md->srcRaw-MIXSRC_CH1);
+    }
+    count = i + 1;
+  }
+
+  while (mixerProgram.count < count) {
+    bool progress = false;
+    for (uint8_t ch=0; ch<NUM_CHNOUT; ch++) {
+      bitfield_channels_t mask = (bitfield_channels_t)1 << ch;
+      if (!(evaluated & mask) && !(dependencies[ch] & ~evaluated)) {
+        for (uint8_t i=firstLine[ch]; i<count && mixAddress(i)->destCh==ch; i++) {
+          mixerProgram.lines[mixerProgram.count++] = i;
+        }
+        evaluated |= mask;
+        progress = true;
+      }
+    }
+    if (!progress) {
+      TRACE("Mixer: channels loop detected, multi-pass evaluation");
+      mixerProgram.count = 0;
+      mixerProgram.state = MIXER_PROGRAM_CYCLIC;
+      return;
+    }
+  }
+
+  // the program order ensures that source channels are classified first
+  mixerProgram.fmDependentChannels = 0;
+  for (uint8_t line=0; line<mixerProgram.count; line++) {
+    MixData * md = mixAddress(mixerProgram.lines[line]);
+    if (isMixFlightModeDependent(md, mixerProgram.fmDependentChannels)) {
+      mixerProgram.fmDependentChannels |= (bitfield_channels_t)1 << md->destCh;
+    }
+  }
+}
+#endif
+
 uint8_t mixerCurrentFlightMode;
 void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
 {
+#if defined(CPUARM)
+  if (mixerProgram.state == MIXER_PROGRAM_DIRTY) {
+    compileMixerProgram();
+  }
+  checkFlightModesInheritance();
+  bool singlePass = (mixerProgram.state == MIXER_PROGRAM_READY);
+  // the flight mode invariant channels computed for the first fading flight mode are kept in chans[]
+  bitfield_channels_t sharedChannels = (fmInvariantsEvaluated && singlePass) ? ~mixerProgram.fmDependentChannels : 0;
+#endif
+
+  MIXER_PROFILE_MARK();
   evalInputs(mode);
+  MIXER_PROFILE_STAGE(MIXER_STAGE_INPUTS);
 
   if (tick10ms) evalLogicalSwitches(mode==e_perout_mode_normal);
+  MIXER_PROFILE_STAGE(MIXER_STAGE_LOGICAL_SWITCHES);
 
 #if defined(MODULE_ALWAYS_SEND_PULSES)
   checkStartupWarnings();
@@ -624,6 +999,9 @@ void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
   }
 #endif
 
+#if defined(CPUARM)
+  if (!sharedChannels)
+#endif
   memclear(chans, sizeof(chans));        // All outputs to 0
 
   //========== MIXER LOOP ===============
@@ -637,7 +1015,17 @@ void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
 
     bitfield_channels_t passDirtyChannels = 0;
 
-    for (uint8_t i=0; i<MAX_MIXERS; i++) {
+    for (uint8_t line=0; line<MAX_MIXERS; line++) {
+
+#if defined(CPUARM)
+      uint8_t i = line;
+      if (singlePass) {
+        if (line >= mixerProgram.count) break;
+        i = mixerProgram.lines[line];
+      }
+#else
+      uint8_t i = line;
+#endif
 
 #if defined(BOLD_FONT)
       if (mode==e_perout_mode_normal && pass==0) swOn[i].activeMix = 0;
@@ -651,6 +1039,10 @@ void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
 
       if (!(dirtyChannels & ((bitfield_channels_t)1 << md->destCh))) continue;
 
+#if defined(CPUARM)
+      if (sharedChannels & ((bitfield_channels_t)1 << md->destCh)) continue;
+#endif
+
       // if this is the first calculation for the destination channel, initialize it with 0 (otherwise would be random)
       if (i == 0 || md->destCh != (md-1)->destCh) {
         chans[md->destCh] = 0;
@@ -706,6 +1098,13 @@ void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
           mixsrc_t srcRaw = MIXSRC_Rud + stickIndex;
           v = getValue(srcRaw);
           srcRaw -= MIXSRC_CH1;
+#if defined(CPUARM)
+          if (singlePass && srcRaw<=MIXSRC_LAST_CH-MIXSRC_CH1 && md->destCh != srcRaw) {
+            // the source channel has already been evaluated in this pass
+            v = chans[srcRaw] >> 8;
+          }
+          else
+#endif
           if (srcRaw<=MIXSRC_LAST_CH-MIXSRC_CH1 && md->destCh != srcRaw) {
             if (dirtyChannels & ((bitfield_channels_t)1 << srcRaw) & (passDirtyChannels|~(((bitfield_channels_t) 1 << md->destCh)-1)))
               passDirtyChannels |= (bitfield_channels_t) 1 << md->destCh;
@@ -940,6 +1339,10 @@ void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
 
   } while (++pass < 5 && dirtyChannels);
 
+#if defined(CPUARM)
+  // the current flight mode is not the last one evaluated during fades
+  if (mode == e_perout_mode_normal)
+#endif
   mixWarning = lv_mixWarning;
 }
 
@@ -965,7 +1368,11 @@ void evalMixes(uint8_t tick10ms)
   static ACTIVE_PHASES_TYPE flightModesFade = 0;
 
   LS_RECURSIVE_EVALUATION_RESET();
-  
+
+#if defined(CPUARM)
+  checkFlightModesInheritance();
+#endif
+
   uint8_t fm = getFlightMode();
 
   if (lastFlightMode != fm) {
@@ -1009,7 +1416,14 @@ void evalMixes(uint8_t tick10ms)
   int32_t weight = 0;
   if (flightModesFade) {
     memclear(sum_chans512, sizeof(sum_chans512));
+#if defined(CPUARM)
+    // the current flight mode is evaluated first and completely, the other fading flight modes
+    // only evaluate the inputs and channels which depend on the flight mode
+    for (uint8_t n=0; n<MAX_FLIGHT_MODES; n++) {
+      uint8_t p = (n == 0 ? fm : (n <= fm ? n-1 : n));
+#else
     for (uint8_t p=0; p<MAX_FLIGHT_MODES; p++) {
+#endif
       LS_RECURSIVE_EVALUATION_RESET();
       if (flightModesFade & ((ACTIVE_PHASES_TYPE)1 << p)) {
         mixerCurrentFlightMode = p;
@@ -1017,15 +1431,23 @@ void evalMixes(uint8_t tick10ms)
         for (uint8_t i=0; i<NUM_CHNOUT; i++)
           sum_chans512[i] += (chans[i] >> 4) * fp_act[p];
         weight += fp_act[p];
+        MIXER_PROFILE_STAGE(MIXER_STAGE_MIXES);
+#if defined(CPUARM)
+        fmInvariantsEvaluated = true;
+#endif
       }
       LS_RECURSIVE_EVALUATION_RESET();
     }
+#if defined(CPUARM)
+    fmInvariantsEvaluated = false;
+#endif
     assert(weight);
     mixerCurrentFlightMode = fm;
   }
   else {
     mixerCurrentFlightMode = fm;
     evalFlightModeMixes(e_perout_mode_normal, tick10ms);
+    MIXER_PROFILE_STAGE(MIXER_STAGE_MIXES);
   }
 
   //========== FUNCTIONS ===============
@@ -1045,8 +1467,12 @@ void evalMixes(uint8_t tick10ms)
     evalFunctions();
 #endif
   }
+  MIXER_PROFILE_STAGE(MIXER_STAGE_FUNCTIONS);
 
   //========== LIMITS ===============
+#if defined(CPUARM)
+  int16_t * outputs = channelOutputsFrames[1 - channelOutputsFrame];
+#endif
   for (uint8_t i=0; i<NUM_CHNOUT; i++) {
     // chans[i] holds data from mixer.   chans[i] = v*weight => 1024*256
     // later we multiply by the limit (up to 100) and then we need to normalize
@@ -1063,11 +1489,21 @@ void evalMixes(uint8_t tick10ms)
 
     int16_t value = applyLimits(i, q);  // applyLimits will remove the 256 100% basis
 
+#if defined(CPUARM)
+    outputs[i] = value;
+#else
     cli();
     channelOutputs[i] = value;  // copy consistent word to int-level
     sei();
+#endif
   }
 
+#if defined(CPUARM)
+  MEMORY_BARRIER(); // the whole frame is written before being published
+  channelOutputsFrame = 1 - channelOutputsFrame;
+#endif
+  MIXER_PROFILE_STAGE(MIXER_STAGE_LIMITS);
+
   if (tick10ms && flightModesFade) {
     uint16_t tick_delta = delta * tick10ms;
     for (uint8_t p=0; p<MAX_FLIGHT_MODES; p++) {
@@ -64,7 +64,13 @@ void loadModelBitmap(char *name, uint8_t *bitmap)
     char lfn[] = BITMAPS_PATH "/xxxxxxxxxx.bmp";
     strncpy(lfn+sizeof(BITMAPS_PATH), name, len);
     strcpy(lfn+sizeof(BITMAPS_PATH)+len, BITMAPS_EXT);
-    if (bmpLoad(bitmap, lfn, MODEL_BITMAP_WIDTH, MODEL_BITMAP_HEIGHT) == 0) {
+    uint16_t id = bmpCacheLoad(lfn, MODEL_BITMAP_WIDTH, MODEL_BITMAP_HEIGHT);
+    if (id) {
+      const uint8_t * bmp = bmpCacheGet(id);
+      memcpy(bitmap, bmp, BITMAP_BUFFER_SIZE(bmp[0], bmp[1]));
+      return;
+    }
+    if (!bmpLoad(bitmap, lfn, MODEL_BITMAP_WIDTH, MODEL_BITMAP_HEIGHT)) {
       return;
     }
   }
@@ -79,7 +85,6 @@ void loadModelBitmap(char *name, uint8_t *bitmap)
 #if !defined(CPUARM)
 uint8_t g_tmr1Latency_max;
 uint8_t g_tmr1Latency_min;
-uint16_t lastMixerDuration;
 #endif
 
 uint8_t unexpectedShutdown = 0;
@@ -87,6 +92,7 @@ uint8_t unexpectedShutdown = 0;
 /* AVR: mixer duration in 1/16ms */
 /* ARM: mixer duration in 0.5us */
 uint16_t maxMixerDuration;
+uint16_t lastMixerDuration;
 
 #if defined(AUDIO) && !defined(CPUARM)
 audioQueue  audio;
@@ -456,6 +462,8 @@ void modelDefault(uint8_t id)
   g_model.mavlink.rc_rssi_scale = 15;
   g_model.mavlink.pc_rssi_en = 1;
 #endif
+
+  INVALIDATE_MIXER_PROGRAM();
 }
 
 #if defined(VIRTUALINPUTS)
@@ -544,10 +552,11 @@ trim_t getRawTrimValue(uint8_t phase, uint8_t idx)
 #endif
 }
 
-int getTrimValue(uint8_t phase, uint8_t idx)
-{
 #if defined(VIRTUALINPUTS)
-  int result = 0;
+// Returns the flight modes whose trims are added for this flight mode
+uint16_t resolveTrimFlightModes(uint8_t phase, uint8_t idx)
+{
+  uint16_t result = 0;
   for (uint8_t i=0; i<MAX_FLIGHT_MODES; i++) {
     trim_t v = getRawTrimValue(phase, idx);
     if (v.mode == TRIM_MODE_NONE) {
@@ -556,17 +565,31 @@ int getTrimValue(uint8_t phase, uint8_t idx)
     else {
       unsigned int p = v.mode >> 1;
       if (p == phase || phase == 0) {
-        return result + v.value;
+        return result | (1 << phase);
       }
       else {
-        phase = p;
         if (v.mode % 2 != 0) {
-          result += v.value;
+          result |= (1 << phase);
         }
+        phase = p;
       }
     }
   }
   return 0;
+}
+#endif
+
+int getTrimValue(uint8_t phase, uint8_t idx)
+{
+#if defined(VIRTUALINPUTS)
+  int result = 0;
+  uint16_t mask = flightModesInheritance.trims[phase][idx];
+  for (uint8_t p=0; mask; p++, mask>>=1) {
+    if (mask & 1) {
+      result += getRawTrimValue(p, idx).value;
+    }
+  }
+  return result;
 #else
   return getRawTrimValue(getTrimFlightPhase(phase, idx), idx);
 #endif
@@ -612,7 +635,11 @@ void setTrimValue(uint8_t phase, uint8_t idx, int trim)
 #endif
 
 #if !defined(VIRTUALINPUTS)
+#if defined(CPUARM)
+uint8_t resolveTrimFlightPhase(uint8_t phase, uint8_t idx)
+#else
 uint8_t getTrimFlightPhase(uint8_t phase, uint8_t idx)
+#endif
 {
   for (uint8_t i=0; i<MAX_FLIGHT_MODES; i++) {
     if (phase == 0) return 0;
@@ -627,9 +654,14 @@ uint8_t getTrimFlightPhase(uint8_t phase, uint8_t idx)
 #endif
 
 #if defined(ROTARY_ENCODERS)
+#if defined(CPUARM)
+uint8_t resolveRotaryEncoderFlightPhase(uint8_t phase, uint8_t idx)
+{
+#else
 uint8_t getRotaryEncoderFlightPhase(uint8_t idx)
 {
   uint8_t phase = mixerCurrentFlightMode;
+#endif
   for (uint8_t i=0; i<MAX_FLIGHT_MODES; i++) {
     if (phase == 0) return 0;
     int16_t value = flightModeAddress(phase)->rotaryEncoders[idx];
@@ -698,7 +730,11 @@ void setGVarValue(uint8_t idx, int8_t value)
 uint8_t s_gvar_timer = 0;
 uint8_t s_gvar_last = 0;
 
+#if defined(CPUARM)
+uint8_t resolveGVarFlightPhase(uint8_t phase, uint8_t idx)
+#else
 uint8_t getGVarFlightPhase(uint8_t phase, uint8_t idx)
+#endif
 {
   for (uint8_t i=0; i<MAX_FLIGHT_MODES; i++) {
     if (phase == 0) return 0;
@@ -738,6 +774,61 @@ void setGVarValue(uint8_t idx, int16_t value, int8_t phase)
 
 #endif
 
+#if defined(CPUARM)
+FlightModesInheritance flightModesInheritance;
+bool flightModesInheritanceDirty = true;
+
+// Only called with mixerMutex held: by the mixer itself, or by the editors with the mixer paused.
+// The getters only read the table, which is one mixer cycle late for the other menus
+void checkFlightModesInheritance()
+{
+  // the flag is cleared first, a model change during the resolution is resolved again
+  while (flightModesInheritanceDirty) {
+    flightModesInheritanceDirty = false;
+    for (uint8_t phase=0; phase<MAX_FLIGHT_MODES; phase++) {
+      for (uint8_t idx=0; idx<NUM_STICKS; idx++) {
+#if defined(VIRTUALINPUTS)
+        flightModesInheritance.trims[phase][idx] = resolveTrimFlightModes(phase, idx);
+#else
+        flightModesInheritance.trims[phase][idx] = resolveTrimFlightPhase(phase, idx);
+#endif
+      }
+#if defined(GVARS)
+      for (uint8_t idx=0; idx<MAX_GVARS; idx++) {
+        flightModesInheritance.gvars[phase][idx] = resolveGVarFlightPhase(phase, idx);
+      }
+#endif
+#if defined(ROTARY_ENCODERS)
+      for (uint8_t idx=0; idx<ROTARY_ENCODERS; idx++) {
+        flightModesInheritance.rotaryEncoders[phase][idx] = resolveRotaryEncoderFlightPhase(phase, idx);
+      }
+#endif
+    }
+  }
+}
+
+#if !defined(VIRTUALINPUTS)
+uint8_t getTrimFlightPhase(uint8_t phase, uint8_t idx)
+{
+  return flightModesInheritance.trims[phase][idx];
+}
+#endif
+
+#if defined(ROTARY_ENCODERS)
+uint8_t getRotaryEncoderFlightPhase(uint8_t idx)
+{
+  return flightModesInheritance.rotaryEncoders[mixerCurrentFlightMode][idx];
+}
+#endif
+
+#if defined(GVARS)
+uint8_t getGVarFlightPhase(uint8_t phase, uint8_t idx)
+{
+  return flightModesInheritance.gvars[phase][idx];
+}
+#endif
+#endif
+
 #if defined(CPUARM)
 getvalue_t convert16bitsTelemValue(source_t channel, ls_telemetry_value_t value)
 {
@@ -1469,6 +1560,9 @@ uint16_t anaIn(uint8_t chan)
 #if defined(CPUARM)
 void getADC()
 {
+#if defined(PCBTARANIS)
+  // the ADC is sampled and filtered continuously by the driver, only its last values are read here
+#else
   uint16_t temp[NUMBER_ANALOG] = { 0 };
 
   for (uint32_t i=0; i<4; i++) {
@@ -1476,15 +1570,16 @@ void getADC()
     for (uint32_t x=0; x<NUMBER_ANALOG; x++) {
       temp[x] += getAnalogValue(x);
     }
-#if defined(VIRTUALINPUTS)
-    if (calibrationState) break;
-#endif
   }
+#endif
 
   for (uint32_t x=0; x<NUMBER_ANALOG; x++) {
+#if defined(PCBTARANIS)
+    uint16_t v = getAnalogValue(x) >> 1;
+#else
     uint16_t v = temp[x] >> 3;
+#endif
 #if defined(VIRTUALINPUTS)
-    if (calibrationState) v = temp[x] >> 1;
     StepsCalibData * calib = (StepsCalibData *) &g_eeGeneral.calib[x];
     if (!calibrationState && IS_POT_MULTIPOS(x) && calib->count>0 && calib->count<XPOTS_MULTIPOS_COUNT) {
       uint8_t vShifted = (v >> 4);
@@ -1608,16 +1703,26 @@ void doMixerCalculations()
   lastTMR = tmr10ms;
 #endif
 
+#if defined(CPUARM)
+  // the frame which evalMixes() will publish is computed from the inputs read now
+  channelOutputsTimes[1 - channelOutputsFrame] = getTmr2MHz();
+#endif
+
+  MIXER_PROFILE_START();
   getADC();
+  MIXER_PROFILE_STAGE(MIXER_STAGE_ADC);
 
 #if defined(PCBTARANIS)
   processSbusInput();
 #endif
 
+  MIXER_PROFILE_MARK();
   getSwitchesPosition(!s_mixer_first_run_done);
+  MIXER_PROFILE_STAGE(MIXER_STAGE_SWITCHES);
 
 #if defined(CPUARM)
   lastTMR = tmr10ms;
+  switchesCacheStart();
 #endif
 
 #if defined(PCBSKY9X) && !defined(REVA) && !defined(SIMU)
@@ -1784,6 +1889,10 @@ void doMixerCalculations()
 #endif
   }
 
+#if defined(CPUARM)
+  switchesCacheStop();
+#endif
+
   s_mixer_first_run_done = true;
 }
 
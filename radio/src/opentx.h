@@ -244,12 +244,14 @@
   #if !defined(NOINLINE)
     #define NOINLINE
   #endif
+  #define MEMORY_BARRIER()
   #define CONVERT_PTR_UINT(x) ((uint32_t)(uint64_t)(x))
   #define CONVERT_UINT_PTR(x) ((uint32_t*)(uint64_t)(x))
   char *convertSimuPath(const char *path);
 #else
   #define FORCEINLINE inline __attribute__ ((always_inline))
   #define NOINLINE __attribute__ ((noinline))
+  #define MEMORY_BARRIER() __asm__ __volatile__ ("" ::: "memory")
   #define SIMU_SLEEP(x)
   #define CONVERT_PTR_UINT(x) ((uint32_t)(x))
   #define CONVERT_UINT_PTR(x) ((uint32_t *)(x))
@@ -456,6 +458,7 @@ extern void boardInit();
 
 #if defined(XCURVES)
   void loadCurves();
+  void invalidateCurveTable(uint8_t idx);
   #define LOAD_MODEL_CURVES() loadCurves()
 #else
   #define LOAD_MODEL_CURVES()
@@ -720,6 +723,34 @@ void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms);
 void evalMixes(uint8_t tick10ms);
 void doMixerCalculations();
 
+#if defined(CPUARM)
+  // The mix lines sorted by channel dependencies, so that one pass is enough
+  enum MixerProgramState {
+    MIXER_PROGRAM_DIRTY,
+    MIXER_PROGRAM_READY,
+    MIXER_PROGRAM_CYCLIC
+  };
+  struct MixerProgram {
+    uint8_t lines[MAX_MIXERS];
+    uint8_t count;
+    uint8_t state;
+    // inputs and channels which may differ from one flight mode to another (trims, GVARs, flight modes masks, ...)
+    uint32_t fmDependentInputs;
+    bitfield_channels_t fmDependentChannels;
+  };
+  extern MixerProgram mixerProgram;
+  void compileMixerProgram();
+  extern bool lswGraphDirty;
+  extern bool flightModesInheritanceDirty;
+  extern bool telemetrySensorsIndexDirty;
+  extern bool telemetrySensorsGraphDirty;
+  // called when the model is loaded and by the mixes, inputs, logical switches, flight modes and sensors editors,
+  // not from eeDirty() which the trims and GVARs changes also call in flight
+  #define INVALIDATE_MIXER_PROGRAM() do { mixerProgram.state = MIXER_PROGRAM_DIRTY; lswGraphDirty = true; flightModesInheritanceDirty = true; telemetrySensorsIndexDirty = true; telemetrySensorsGraphDirty = true; } while (0)
+#else
+  #define INVALIDATE_MIXER_PROGRAM()
+#endif
+
 #if defined(CPUARM)
   void checkTrims();
 #endif
@@ -730,7 +761,10 @@ getvalue_t getValue(mixsrc_t i);
 
 #if defined(CPUARM)
 #define GETSWITCH_MIDPOS_DELAY   1
+#define GETSWITCH_NO_CACHE       2
 bool getSwitch(int8_t swtch, uint8_t flags=0);
+void switchesCacheStart();
+void switchesCacheStop();
 #else
 bool getSwitch(int8_t swtch);
 #endif
@@ -781,6 +815,25 @@ int8_t  getMovedSwitch();
   #define getTrimFlightPhase(phase, idx) (phase)
 #endif
 
+#if defined(CPUARM)
+  // The trims, GVARs and rotary encoders flight modes inheritance, resolved when the model changes
+  struct FlightModesInheritance {
+#if defined(PCBTARANIS)
+    uint16_t trims[MAX_FLIGHT_MODES][NUM_STICKS]; // the flight modes whose trims are added
+#else
+    uint8_t trims[MAX_FLIGHT_MODES][NUM_STICKS];
+#endif
+#if defined(GVARS)
+    uint8_t gvars[MAX_FLIGHT_MODES][MAX_GVARS];
+#endif
+#if defined(ROTARY_ENCODERS)
+    uint8_t rotaryEncoders[MAX_FLIGHT_MODES][ROTARY_ENCODERS];
+#endif
+  };
+  extern FlightModesInheritance flightModesInheritance;
+  void checkFlightModesInheritance();
+#endif
+
 #if defined(GVARS)
   extern int8_t trimGvar[NUM_STICKS];
   #define TRIM_REUSED(idx) trimGvar[idx] >= 0
@@ -798,6 +851,7 @@ int getTrimValue(uint8_t phase, uint8_t idx);
 #endif
 
 #if defined(ROTARY_ENCODERS)
+  uint8_t getRotaryEncoderFlightPhase(uint8_t idx);
   int16_t getRotaryEncoder(uint8_t idx);
   void incRotaryEncoder(uint8_t idx, int8_t inc);
 #endif
@@ -892,11 +946,11 @@ void flightReset();
 extern uint8_t unexpectedShutdown;
 
 extern uint16_t maxMixerDuration;
+extern uint16_t lastMixerDuration;
 
 #if !defined(CPUARM)
 extern uint8_t g_tmr1Latency_max;
 extern uint8_t g_tmr1Latency_min;
-extern uint16_t lastMixerDuration;
 #endif
 
 #if defined(CPUARM)
@@ -1046,6 +1100,13 @@ extern "C" {
 #endif
 
 extern OS_MutexID mixerMutex;
+extern OS_FlagID mixerFlag;
+extern OS_FlagID telemetryFlag;
+extern OS_MutexID logsMutex;
+extern OS_FlagID logsFlag;
+#if defined(LUA)
+extern OS_MutexID luaMutex;
+#endif
 inline void pauseMixerCalculations()
 {
   CoEnterMutexSection(mixerMutex);
@@ -1131,7 +1192,17 @@ extern uint8_t            g_beepVal[5];
 
 extern int32_t            chans[NUM_CHNOUT];
 extern int16_t            ex_chans[NUM_CHNOUT]; // Outputs (before LIMITS) of the last perMain
+#if defined(CPUARM)
+// The mixer writes the outputs to the frame which is not published, then publishes it with a single
+// index write: the pulses, set up from interrupts, always read a complete frame from the same cycle
+extern int16_t            channelOutputsFrames[2][NUM_CHNOUT];
+extern volatile uint8_t   channelOutputsFrame;
+#define channelOutputs    (channelOutputsFrames[channelOutputsFrame])
+extern uint16_t           channelOutputsTimes[2]; // getTmr2MHz() when the inputs of each frame were read
+#define channelOutputsTime (channelOutputsTimes[channelOutputsFrame])
+#else
 extern int16_t            channelOutputs[NUM_CHNOUT];
+#endif
 extern uint16_t           BandGap;
 
 #if defined(VIRTUALINPUTS)
@@ -1142,6 +1213,9 @@ extern uint16_t           BandGap;
 
 int intpol(int x, uint8_t idx);
 int expo(int x, int k);
+#if defined(CPUARM)
+  int computeExpo(int x, int k);
+#endif
 
 #if defined(CURVES) && defined(XCURVES)
   int applyCurve(int x, CurveRef & curve);
@@ -1167,13 +1241,14 @@ int expo(int x, int k);
 
 #if defined(XCURVES)
   int applyCustomCurve(int x, uint8_t idx);
+  int computeCustomCurve(int x, uint8_t idx);
 #else
   #define applyCustomCurve(x, idx) intpol(x, idx)
 #endif
 
 #if defined(XCURVES)
-  #define APPLY_EXPOS_EXTRA_PARAMS_INC , uint8_t ovwrIdx=0, int16_t ovwrValue=0
-  #define APPLY_EXPOS_EXTRA_PARAMS     , uint8_t ovwrIdx, int16_t ovwrValue
+  #define APPLY_EXPOS_EXTRA_PARAMS_INC , uint8_t ovwrIdx=0, int16_t ovwrValue=0, uint32_t skippedInputs=0
+  #define APPLY_EXPOS_EXTRA_PARAMS     , uint8_t ovwrIdx, int16_t ovwrValue, uint32_t skippedInputs
 #else
   #define APPLY_EXPOS_EXTRA_PARAMS_INC
   #define APPLY_EXPOS_EXTRA_PARAMS
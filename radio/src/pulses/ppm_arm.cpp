@@ -67,10 +67,11 @@ void setupPulsesPPM(unsigned int port)                   // Don't enable interru
   ppmPulsesData->ptr = ptr;
 #endif
 
+  const int16_t * channels = channelOutputs; // the last complete frame
   int32_t rest = 22500u * 2;
   rest += (int32_t(g_model.moduleData[port].ppmFrameLength)) * 1000;
   for (uint32_t i=firstCh; i<lastCh; i++) {
-    int16_t v = limit((int16_t)-PPM_range, channelOutputs[i], (int16_t)PPM_range) + 2*PPM_CH_CENTER(i);
+    int16_t v = limit((int16_t)-PPM_range, channels[i], (int16_t)PPM_range) + 2*PPM_CH_CENTER(i);
     rest -= v;
     *ptr++ = v; /* as Pat MacKenzie suggests */
   }
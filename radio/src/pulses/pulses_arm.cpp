@@ -40,6 +40,8 @@ uint8_t s_pulses_paused = 0;
 uint8_t s_current_protocol[NUM_MODULES] = { MODULES_INIT(255) };
 uint16_t failsafeCounter[NUM_MODULES] = { MODULES_INIT(100) };
 uint8_t moduleFlag[NUM_MODULES] = { 0 };
+uint16_t lastFrameLatency = 0;
+uint16_t maxFrameLatency = 0;
 
 ModulePulsesData modulePulsesData[NUM_MODULES] _NOCCM;
 TrainerPulsesData trainerPulsesData _NOCCM;
@@ -160,6 +162,11 @@ void setupPulses(unsigned int port)
     }
   }
 
+  if (required_protocol != PROTO_NONE) {
+    lastFrameLatency = getTmr2MHz() - channelOutputsTime;
+    if (lastFrameLatency > maxFrameLatency) maxFrameLatency = lastFrameLatency;
+  }
+
   // Set up output data here
   switch (required_protocol) {
     case PROTO_PXX:
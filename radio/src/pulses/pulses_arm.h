@@ -47,6 +47,10 @@ extern uint8_t s_current_protocol[NUM_MODULES];
 extern uint8_t s_pulses_paused;
 extern uint16_t failsafeCounter[NUM_MODULES];
 
+// Time between the inputs reading and the frame latch by the module (0.5us)
+extern uint16_t lastFrameLatency;
+extern uint16_t maxFrameLatency;
+
 #if defined(PCBSKY9X)
 PACK(struct PpmPulsesData {
   uint16_t pulses[20];
@@ -174,6 +174,7 @@ void putPcmHead(unsigned int port)
 void setupPulsesPXX(unsigned int port)
 {
   uint16_t chan=0, chan_low=0;
+  const int16_t * channels = channelOutputs; // the last complete frame
 
   modulePulsesData[port].pxx.ptr = modulePulsesData[port].pxx.pulses;
   modulePulsesData[port].pxx.pcmValue = 0 ;
@@ -252,9 +253,9 @@ void setupPulsesPXX(unsigned int port)
     }
     else {
       if (i < sendUpperChannels)
-        chan = limit(2049, PPM_CH_CENTER(8+g_model.moduleData[port].channelsStart+i) - PPM_CENTER + (channelOutputs[8+g_model.moduleData[port].channelsStart+i] * 512 / 682) + 3072, 4094);
+        chan = limit(2049, PPM_CH_CENTER(8+g_model.moduleData[port].channelsStart+i) - PPM_CENTER + (channels[8+g_model.moduleData[port].channelsStart+i] * 512 / 682) + 3072, 4094);
       else if (i < NUM_CHANNELS(port))
-        chan = limit(1, PPM_CH_CENTER(g_model.moduleData[port].channelsStart+i) - PPM_CENTER + (channelOutputs[g_model.moduleData[port].channelsStart+i] * 512 / 682) + 1024, 2046);
+        chan = limit(1, PPM_CH_CENTER(g_model.moduleData[port].channelsStart+i) - PPM_CENTER + (channels[g_model.moduleData[port].channelsStart+i] * 512 / 682) + 1024, 2046);
       else
         chan = 1024;
     }
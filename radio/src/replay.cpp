@@ -0,0 +1,287 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+// Headless replay of recorded inputs through the mixer
+//
+//   make PCB=TARANIS replay
+//   ./replay [-m model] [-b] [-o output] eeprom.bin trace
+//
+// The trace is a CSV file, or a binary file starting with REPLAY_BINARY_MAGIC. Each record is applied
+// at its tick (10ms unit, in increasing order) and its values are kept until the next record of the same kind:
+//   <tick>,a,<adc1>,<adc2>,...    raw ADC values, in the order of anaIn()
+//   <tick>,s,<sw1>,<sw2>,...      switches positions (-1, 0 or 1), in the order of simuSetSwitch()
+//   <tick>,t,<hex bytes>          telemetry bytes received during the tick
+// Lines starting with '#' are comments. A binary record is a uint32_t tick, a char kind ('a', 's' or 't'),
+// a uint8_t count, then count uint16_t, int8_t or uint8_t values, all little endian.
+//
+// The mixer runs once per tick, without the 10ms pacing of the simulator main thread, and the
+// channelOutputs are written after each tick as CSV (tick,ch1,ch2,...) or, with -b, as binary
+// records (uint32_t tick, int16_t outputs[NUM_CHNOUT]).
+
+#include <unistd.h>
+#include <ctype.h>
+#include "opentx.h"
+
+#define REPLAY_BINARY_MAGIC   "OTXTRACE"
+#define REPLAY_MAX_VALUES     255
+#define REPLAY_LINE_SIZE      2048
+
+struct ReplayRecord {
+  uint32_t tick;
+  char kind;
+  uint8_t count;
+  int16_t values[REPLAY_MAX_VALUES];
+};
+
+uint16_t replayAnalogs[NUMBER_ANALOG];
+
+uint16_t anaIn(uint8_t chan)
+{
+  if (chan < NUMBER_ANALOG)
+    return replayAnalogs[chan];
+  else
+    return 0;
+}
+
+static bool readBinaryRecord(FILE * f, ReplayRecord & record)
+{
+  uint8_t header[6];
+  if (fread(header, 1, sizeof(header), f) != sizeof(header)) {
+    return false;
+  }
+  record.tick = header[0] + (header[1] << 8) + (header[2] << 16) + ((uint32_t)header[3] << 24);
+  record.kind = header[4];
+  record.count = header[5];
+  for (int i=0; i<record.count; i++) {
+    uint8_t value[2];
+    if (record.kind == 'a') {
+      if (fread(value, 1, 2, f) != 2) return false;
+      record.values[i] = value[0] + (value[1] << 8);
+    }
+    else {
+      if (fread(value, 1, 1, f) != 1) return false;
+      record.values[i] = (record.kind == 's' ? (int8_t)value[0] : value[0]);
+    }
+  }
+  return true;
+}
+
+static bool readCsvRecord(FILE * f, ReplayRecord & record)
+{
+  char line[REPLAY_LINE_SIZE];
+
+  while (fgets(line, sizeof(line), f)) {
+    char * s = line;
+    if (*s == '#' || *s == '\r' || *s == '\n') {
+      continue;
+    }
+    record.tick = strtoul(s, &s, 10);
+    if (*s++ != ',' || !*s) {
+      fprintf(stderr, "bad trace line: %s", line);
+      continue;
+    }
+    record.kind = *s++;
+    record.count = 0;
+    if (record.kind == 't') {
+      // the telemetry bytes are one hex string
+      while (*s && record.count < REPLAY_MAX_VALUES) {
+        if (isxdigit(s[0]) && isxdigit(s[1])) {
+          char hex[3] = { s[0], s[1], '\0' };
+          record.values[record.count++] = strtoul(hex, NULL, 16);
+          s += 2;
+        }
+        else {
+          s++;
+        }
+      }
+    }
+    else {
+      while (*s == ',' && record.count < REPLAY_MAX_VALUES) {
+        record.values[record.count++] = strtol(s+1, &s, 10);
+      }
+    }
+    return true;
+  }
+
+  return false;
+}
+
+static void applyRecord(const ReplayRecord & record)
+{
+  switch (record.kind) {
+    case 'a':
+      for (int i=0; i<record.count && i<NUMBER_ANALOG; i++) {
+        replayAnalogs[i] = record.values[i];
+      }
+      break;
+
+    case 's':
+      for (int i=0; i<record.count && i<NUM_SWITCHES; i++) {
+        simuSetSwitch(i, record.values[i]);
+      }
+      break;
+
+    case 't':
+#if defined(FRSKY)
+      for (int i=0; i<record.count; i++) {
+        processSerialData(record.values[i]);
+      }
+#else
+      {
+        static bool warned = false;
+        if (!warned) {
+          fprintf(stderr, "telemetry records ignored, this firmware has no FrSky telemetry\n");
+          warned = true;
+        }
+      }
+#endif
+      break;
+
+    default:
+      fprintf(stderr, "unknown trace record '%c' at tick %u\n", record.kind, record.tick);
+      break;
+  }
+}
+
+static void writeOutputs(FILE * f, uint32_t tick, bool binary)
+{
+  if (binary) {
+    fwrite(&tick, sizeof(tick), 1, f);
+    fwrite(channelOutputs, sizeof(channelOutputs[0]), NUM_CHNOUT, f);
+  }
+  else {
+    fprintf(f, "%u", tick);
+    for (int i=0; i<NUM_CHNOUT; i++) {
+      fprintf(f, ",%d", channelOutputs[i]);
+    }
+    fputc('\n', f);
+  }
+}
+
+static int usage()
+{
+  fprintf(stderr, "usage: replay [-m model] [-b] [-o output] eeprom.bin trace\n");
+  return 1;
+}
+
+int main(int argc, char **argv)
+{
+  int model = -1;
+  bool binaryOutput = false;
+  const char * outputPath = NULL;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "m:bo:")) != -1) {
+    switch (opt) {
+      case 'm':
+        model = atoi(optarg) - 1;
+        break;
+      case 'b':
+        binaryOutput = true;
+        break;
+      case 'o':
+        outputPath = optarg;
+        break;
+      default:
+        return usage();
+    }
+  }
+
+  if (argc - optind != 2) {
+    return usage();
+  }
+
+  FILE * trace = fopen(argv[optind+1], "rb");
+  if (!trace) {
+    perror(argv[optind+1]);
+    return 1;
+  }
+  char magic[sizeof(REPLAY_BINARY_MAGIC)-1];
+  bool binaryTrace = (fread(magic, 1, sizeof(magic), trace) == sizeof(magic) && !memcmp(magic, REPLAY_BINARY_MAGIC, sizeof(magic)));
+  if (!binaryTrace) {
+    rewind(trace);
+  }
+
+  // the simulator traces go to stdout, they are moved to stderr to keep the outputs alone on stdout
+  FILE * output = (outputPath ? fopen(outputPath, "wb") : fdopen(dup(STDOUT_FILENO), "wb"));
+  if (!output) {
+    perror(outputPath);
+    return 1;
+  }
+  dup2(STDERR_FILENO, STDOUT_FILENO);
+
+  simuInit();
+  StartEepromThread(NULL);
+
+  if (!simuLoadEepromImage(argv[optind])) {
+    return 1;
+  }
+  if (model < 0) {
+    model = g_eeGeneral.currModel;
+  }
+  if (model >= MAX_MODELS || !eeModelExists(model)) {
+    fprintf(stderr, "model %d not found\n", model+1);
+    return 1;
+  }
+  eeLoadModel(model);
+
+  // the analogs not given by the trace stay at their calibrated center
+  for (int i=0; i<NUM_STICKS+NUM_POTS; i++) {
+    replayAnalogs[i] = g_eeGeneral.calib[i].mid;
+  }
+
+  ReplayRecord record;
+  uint32_t lastTick = 0;
+  bool more = (binaryTrace ? readBinaryRecord(trace, record) : readCsvRecord(trace, record));
+
+  for (uint32_t tick=0; more || tick<=lastTick; tick++) {
+    while (more && record.tick <= tick) {
+      applyRecord(record);
+      lastTick = record.tick;
+      more = (binaryTrace ? readBinaryRecord(trace, record) : readCsvRecord(trace, record));
+    }
+    per10ms();
+    doMixerCalculations();
+#if defined(CPUARM) && (defined(FRSKY) || defined(MAVLINK))
+    telemetryWakeup();
+#endif
+    writeOutputs(output, tick, binaryOutput);
+  }
+
+  fclose(trace);
+  fclose(output);
+  return 0;
+}
@@ -58,7 +58,11 @@
 #define SCRIPTS_TELEM_PATH  SCRIPTS_PATH "/TELEMETRY"
 
 #define MODELS_EXT          ".bin"
-#define LOGS_EXT            ".csv"
+#if defined(BINARY_LOGS)
+  #define LOGS_EXT          ".tlg"
+#else
+  #define LOGS_EXT          ".csv"
+#endif
 #define SOUNDS_EXT          ".wav"
 #define BITMAPS_EXT         ".bmp"
 #define SCRIPTS_EXT         ".lua"
@@ -75,6 +79,11 @@ const pm_char *openLogs();
 void writeHeader();
 void closeLogs();
 void writeLogs();
+#if defined(CPUARM)
+void flushLogs();
+extern uint16_t logsBufferHighWater;
+extern uint16_t logsDroppedRecords;
+#endif
 
 uint32_t sdGetNoSectors();
 uint32_t sdGetSize();
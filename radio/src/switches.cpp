@@ -60,6 +60,29 @@ PACK(typedef struct {
 LogicalSwitchesFlightModeContext lswFm[MAX_FLIGHT_MODES];
 
 #define LS_LAST_VALUE(fm, idx) lswFm[fm].lsw[idx].lastValue
+
+// The physical switches, multipos switches and trims positions are read only once per mixer cycle.
+// Each entry holds the generation of the cycle (7 bits) and the position (bit 0), the logical
+// switches states are already computed once per cycle in lswFm
+#define SWITCHES_CACHE_SIZE   (SWSRC_LAST_TRIM-SWSRC_FIRST_SWITCH+1)
+uint8_t switchesCache[SWITCHES_CACHE_SIZE];
+uint8_t switchesCacheGeneration = 0; // 0 when no mixer cycle is running
+
+void switchesCacheStart()
+{
+  static uint8_t generation = 0;
+  if (++generation > 0x7F) {
+    // the older entries could match the new generations
+    memclear(switchesCache, sizeof(switchesCache));
+    generation = 1;
+  }
+  switchesCacheGeneration = generation;
+}
+
+void switchesCacheStop()
+{
+  switchesCacheGeneration = 0;
+}
         
 #else
 
@@ -442,6 +465,19 @@ bool getSwitch(int8_t swtch)
   else if (cs_idx == SWSRC_ON) {
     result = true;
   }
+#if defined(CPUARM)
+  else if (cs_idx <= SWSRC_LAST_TRIM && switchesCacheGeneration && !(flags & (GETSWITCH_MIDPOS_DELAY|GETSWITCH_NO_CACHE))) {
+    uint8_t generation = switchesCacheGeneration;
+    uint8_t & entry = switchesCache[cs_idx-SWSRC_FIRST_SWITCH];
+    if ((entry >> 1) == generation) {
+      result = (entry & 1);
+    }
+    else {
+      result = getSwitch(cs_idx, GETSWITCH_NO_CACHE);
+      entry = (generation << 1) + result;
+    }
+  }
+#endif
   else if (cs_idx <= SWSRC_LAST_SWITCH) {
 #if defined(PCBTARANIS)
     if (flags & GETSWITCH_MIDPOS_DELAY) {
@@ -530,14 +566,161 @@ bool getSwitch(int8_t swtch)
 }
 
 #if defined(CPUARM)
+#if NUM_LOGICAL_SWITCH > 32
+  #define bitfield_lsw_t uint64_t
+#else
+  #define bitfield_lsw_t uint32_t
+#endif
+
+#define LSW_BIT(idx)    ((bitfield_lsw_t)1 << (idx))
+#define LSW_MAX_NODES   (NUM_LOGICAL_SWITCH*3)
+
+// Each distinct source or switch read by the logical switches is a node, read only once per tick
+PACK(typedef struct {
+  getvalue_t value;
+  bitfield_lsw_t readers;
+  uint16_t source:15;
+  uint16_t isSwitch:1;
+}) LogicalSwitchNode;
+
+// The logical switches dependency graph, built when the model changes
+struct LogicalSwitchesGraph {
+  LogicalSwitchNode nodes[LSW_MAX_NODES];
+  bitfield_lsw_t readers[NUM_LOGICAL_SWITCH]; // the logical switches reading each logical switch
+  bitfield_lsw_t stateful;  // timers, sticky, edge, delta, delay and duration are evaluated at each tick
+  bitfield_lsw_t telemetry; // the logical switches on telemetry sources depend on the streaming state
+  bitfield_lsw_t pending;   // the logical switches to evaluate on next tick
+  uint8_t nodesCount;
+  uint8_t flightMode;
+  uint8_t telemetryState;
+};
+
+LogicalSwitchesGraph lswGraph;
+bool lswGraphDirty = true;
+
+getvalue_t getLogicalSwitchNodeValue(const LogicalSwitchNode & node)
+{
+  if (node.isSwitch)
+    return getSwitch(node.source);
+  else
+    return getValueForLogicalSwitch(node.source);
+}
+
+void addLogicalSwitchNode(uint8_t idx, uint16_t source, bool isSwitch)
+{
+  LogicalSwitchNode * node = lswGraph.nodes;
+  for (; node<&lswGraph.nodes[lswGraph.nodesCount]; node++) {
+    if (node->source == source && node->isSwitch == isSwitch) {
+      break;
+    }
+  }
+  if (node == &lswGraph.nodes[lswGraph.nodesCount]) {
+    node->source = source;
+    node->isSwitch = isSwitch;
+    node->value = getLogicalSwitchNodeValue(*node);
+    node->readers = 0;
+    lswGraph.nodesCount++;
+  }
+  node->readers |= LSW_BIT(idx);
+}
+
+void addLogicalSwitchSwitchInput(uint8_t idx, int8_t swtch)
+{
+  uint8_t cs_idx = abs(swtch);
+  if (cs_idx >= SWSRC_FIRST_LOGICAL_SWITCH && cs_idx <= SWSRC_LAST_LOGICAL_SWITCH)
+    lswGraph.readers[cs_idx-SWSRC_FIRST_LOGICAL_SWITCH] |= LSW_BIT(idx);
+  else if (cs_idx != SWSRC_NONE && cs_idx != SWSRC_ON)
+    addLogicalSwitchNode(idx, cs_idx, true);
+}
+
+void addLogicalSwitchSourceInput(uint8_t idx, mixsrc_t source)
+{
+  if (source >= MIXSRC_FIRST_LOGICAL_SWITCH && source <= MIXSRC_LAST_LOGICAL_SWITCH)
+    lswGraph.readers[source-MIXSRC_FIRST_LOGICAL_SWITCH] |= LSW_BIT(idx);
+  else if (source != MIXSRC_NONE)
+    addLogicalSwitchNode(idx, source, false);
+}
+
+void buildLogicalSwitchesGraph()
+{
+  memclear(&lswGraph, sizeof(lswGraph));
+
+  for (uint8_t idx=0; idx<NUM_LOGICAL_SWITCH; idx++) {
+    LogicalSwitchData * ls = lswAddress(idx);
+    if (ls->func == LS_FUNC_NONE) {
+      continue;
+    }
+    uint8_t family = lswFamily(ls->func);
+    if (ls->delay || ls->duration || family == LS_FAMILY_DIFF || family >= LS_FAMILY_TIMER) {
+      lswGraph.stateful |= LSW_BIT(idx);
+      continue;
+    }
+    addLogicalSwitchSwitchInput(idx, ls->andsw);
+    if (family == LS_FAMILY_BOOL) {
+      addLogicalSwitchSwitchInput(idx, ls->v1);
+      addLogicalSwitchSwitchInput(idx, ls->v2);
+    }
+    else {
+      addLogicalSwitchSourceInput(idx, ls->v1);
+      if (family == LS_FAMILY_COMP)
+        addLogicalSwitchSourceInput(idx, ls->v2);
+      else if (ls->v1 >= MIXSRC_FIRST_TELEM)
+        lswGraph.telemetry |= LSW_BIT(idx);
+    }
+  }
+
+  lswGraph.pending = (bitfield_lsw_t)-1;
+  lswGraph.flightMode = mixerCurrentFlightMode;
+  lswGraphDirty = false;
+}
+
 /**
   @brief Calculates new state of logical switches for mixerCurrentFlightMode
+
+  Only the logical switches whose inputs changed since their last evaluation are evaluated again.
+  A logical switch reading a logical switch placed after it sees its change on next tick, as it
+  would when evaluating all of them in order.
 */
 void evalLogicalSwitches(bool isCurrentPhase)
 {
+  if (lswGraphDirty) {
+    buildLogicalSwitchesGraph();
+  }
+
+  bitfield_lsw_t pending = lswGraph.pending | lswGraph.stateful;
+
+  if (lswGraph.flightMode != mixerCurrentFlightMode) {
+    // each flight mode has its own logical switches states
+    lswGraph.flightMode = mixerCurrentFlightMode;
+    pending = (bitfield_lsw_t)-1;
+  }
+
+#if defined(FRSKY)
+  uint8_t telemetryState = TELEMETRY_STREAMING() + (IS_FAI_ENABLED() << 1);
+  if (telemetryState != lswGraph.telemetryState) {
+    lswGraph.telemetryState = telemetryState;
+    pending |= lswGraph.telemetry;
+  }
+#endif
+
+  for (LogicalSwitchNode * node=lswGraph.nodes; node<&lswGraph.nodes[lswGraph.nodesCount]; node++) {
+    getvalue_t value = getLogicalSwitchNodeValue(*node);
+    if (value != node->value) {
+      node->value = value;
+      pending |= node->readers;
+    }
+  }
+
   for (unsigned int idx=0; idx<NUM_LOGICAL_SWITCH; idx++) {
+    if (!(pending & LSW_BIT(idx))) {
+      continue;
+    }
+    pending &= ~LSW_BIT(idx);
     LogicalSwitchContext &context = lswFm[mixerCurrentFlightMode].lsw[idx];
     bool result = getLogicalSwitch(idx);
+    if (result != context.state) {
+      pending |= lswGraph.readers[idx];
+    }
     if (isCurrentPhase) {
       if (result) {
         if (!context.state) PLAY_LOGICAL_SWITCH_ON(idx);
@@ -548,6 +731,8 @@ void evalLogicalSwitches(bool isCurrentPhase)
     }
     context.state = result;
   }
+
+  lswGraph.pending = pending;
 }
 #endif
 
@@ -895,6 +1080,7 @@ void logicalSwitchesReset()
 #if defined(CPUARM)
   flightModeTransitionLast = 255;
   memset(lswFm, 0, sizeof(lswFm));
+  lswGraphDirty = true;
 #else
   s_last_switch_value = 0;
 #endif
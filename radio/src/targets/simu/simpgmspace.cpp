@@ -73,6 +73,7 @@ USART_TypeDef Usart0, Usart1, Usart2, Usart3, Usart4;
 #elif defined(CPUARM)
 Pio Pioa, Piob, Pioc;
 Pwm pwm;
+Tc tc1;
 Twi Twio;
 Usart Usart0;
 Dacc dacc;
@@ -367,10 +368,18 @@ void *main_thread(void *)
       doMixerCalculations();
 #if defined(FRSKY) || defined(MAVLINK)
       telemetryWakeup();
+#endif
+#if defined(LUA)
+      if (luaMixScriptsDue()) {
+        luaRunMixScripts();
+      }
 #endif
       checkTrims();
 #endif
       perMain();
+#if defined(CPUARM)
+      flushLogs();
+#endif
       sleep(10/*ms*/);
     }
 
@@ -410,6 +419,11 @@ void StartMainThread(bool tests)
 #if defined(CPUARM)
   pthread_mutex_init(&mixerMutex, NULL);
   pthread_mutex_init(&audioMutex, NULL);
+  pthread_mutex_init(&logsMutex, NULL);
+#endif
+
+#if defined(LUA)
+  pthread_mutex_init(&luaMutex, NULL);
 #endif
 
   /*
@@ -624,6 +638,24 @@ void StopEepromThread()
   if (fp) fclose(fp);
 }
 
+// loads an eeprom image in the simulated eeprom (without any eeprom thread), used by the replay and the benchmark
+bool simuLoadEepromImage(const char * path)
+{
+  FILE * f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return false;
+  }
+  memclear(eeprom, EESIZE_SIMU);
+  size_t size = fread(eeprom, 1, EESIZE_SIMU, f);
+  fclose(f);
+  if (size == 0 || !eepromOpen() || !eeLoadGeneral()) {
+    fprintf(stderr, "%s: not a valid eeprom image\n", path);
+    return false;
+  }
+  return true;
+}
+
 void eepromReadBlock (uint8_t * pointer_ram, uint32_t pointer_eeprom, uint32_t size)
 {
   assert(size);
@@ -784,7 +816,7 @@ char *findTrueFileName(const char *path)
   return result;
 }
 
-FRESULT f_stat (const TCHAR * name, FILINFO *)
+FRESULT f_stat (const TCHAR * name, FILINFO * fno)
 {
   char *path = convertSimuPath(name);
   char * realPath = findTrueFileName(path);
@@ -795,6 +827,12 @@ FRESULT f_stat (const TCHAR * name, FILINFO *)
   }
   else {
     TRACE("f_stat(%s) = OK", path);
+    if (fno) {
+      struct tm * ltm = localtime(&tmp.st_mtime);
+      fno->fsize = tmp.st_size;
+      fno->fdate = ((ltm->tm_year - 80) << 9) | ((ltm->tm_mon + 1) << 5) | ltm->tm_mday;
+      fno->ftime = (ltm->tm_hour << 11) | (ltm->tm_min << 5) | (ltm->tm_sec / 2);
+    }
     return FR_OK;
   }
 }
@@ -854,6 +892,12 @@ FRESULT f_lseek (FIL* fil, DWORD offset)
   return FR_OK;
 }
 
+FRESULT f_truncate (FIL* fil)
+{
+  // f_lseek() doesn't stretch the files here, there is nothing to release
+  return FR_OK;
+}
+
 FRESULT f_close (FIL * fil)
 {
   if (fil && fil->fs) {
@@ -1189,7 +1233,20 @@ void lcdOff()
 
 void lcdRefresh()
 {
+#if defined(PCBTARANIS)
+  // same partial refresh as the radio
+  uint32_t pages = lcdGetChangedPages();
+  if (!pages) {
+    return;
+  }
+  for (uint8_t page=0; page<LCD_PAGES; page++) {
+    if (pages & (1 << page)) {
+      memcpy(&lcd_buf[page * LCD_W], &displayBuf[page * LCD_W], LCD_W);
+    }
+  }
+#else
   memcpy(lcd_buf, displayBuf, sizeof(lcd_buf));
+#endif
   lcd_refresh = true;
 }
 
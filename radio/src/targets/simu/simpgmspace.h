@@ -186,6 +186,9 @@ extern Adc Adc0;
 extern Pwm pwm;
 #undef PWM
 #define PWM (&pwm)
+extern Tc tc1;
+#undef TC1
+#define TC1 (&tc1)
 #endif
 
 extern sem_t *eeprom_write_sem;
@@ -363,6 +366,7 @@ void StartMainThread(bool tests=true);
 void StopMainThread();
 void StartEepromThread(const char *filename="eeprom.bin");
 void StopEepromThread();
+bool simuLoadEepromImage(const char * path);
 #if defined(SIMU_AUDIO) && defined(CPUARM)
   void StartAudioThread(int volumeGain = 10);
   void StopAudioThread(void);
@@ -42,7 +42,22 @@
 #define PIN_PORTC   0x0200
 
 // Sample time should exceed 1uS
-#define SAMPTIME    2   // sample time = 28 cycles
+#define SAMPTIME    6   // sample time = 144 cycles
+
+// The ADCs convert continuously into circular DMA buffers of 2*ADC_SCANS_PER_HALF scans, each half buffer
+// is filtered on its DMA interrupt. The mixer only reads the last filtered values.
+// With the ADC clock at PCLK2/4 (15MHz, 21MHz on the 9E) one conversion takes 156 cycles, 10.4us, a scan
+// of the 10 ADC1 channels 104us, so a half buffer of 4 scans is filtered every 416us.
+// Latency of a stick step, from the conversion timings and the step response of adcFilterScans() in the
+// Adc gtests: with the IIR (time constant 3.5 scans, 0.36ms) 68% of the step is in Analog_values after
+// 0.42 to 0.83ms and 99% after 1.7 to 2.1ms. The average of the 4 scans has it all after 0.42 to 0.83ms
+// but about 30% more noise.
+#define IIR_SHIFT   2   // IIR coefficient = 1/4 per scan
+#define IIR_FRAC    4   // fractional bits of the IIR state
+
+#if !defined(ADC_FILTER_DEFAULT)
+  #define ADC_FILTER_DEFAULT ADC_FILTER_IIR
+#endif
 
 #if defined(REV9E)
   const int8_t ana_direction[NUMBER_ANALOG] = {1,1,-1,-1,  -1,-1,-1,1, -1,1,1,1,  -1};
@@ -66,7 +81,14 @@
     #define NUMBER_ANALOG_ADC1      10
 #endif
 
-uint16_t Analog_values[NUMBER_ANALOG] _NOCCM;
+uint16_t Analog_values[NUMBER_ANALOG];  // filtered values
+uint16_t adc1Samples[2*ADC_SCANS_PER_HALF][NUMBER_ANALOG_ADC1] _NOCCM;
+#if defined(REV9E)
+uint16_t adc3Samples[2*ADC_SCANS_PER_HALF][NUMBER_ANALOG_ADC3] _NOCCM;
+#endif
+int32_t adcIirState[NUMBER_ANALOG];
+uint16_t adcIirInitialized; // 1 bit per channel, its IIR state starts from its first sample
+uint8_t adcFilterMode = ADC_FILTER_DEFAULT;
 
 void adcInit()
 {
@@ -86,7 +108,7 @@ void adcInit()
 #endif
 
   ADC1->CR1 = ADC_CR1_SCAN;
-  ADC1->CR2 = ADC_CR2_ADON | ADC_CR2_DMA | ADC_CR2_DDS;
+  ADC1->CR2 = ADC_CR2_ADON | ADC_CR2_DMA | ADC_CR2_DDS | ADC_CR2_CONT;
   ADC1->SQR1 = (NUMBER_ANALOG_ADC1-1) << 20 ; // bits 23:20 = number of conversions
 #if defined(REV9E)
   ADC1->SQR2 = (ADC_CHANNEL_POT4<<0) + (ADC_CHANNEL_SLIDER3<<5) + (ADC_CHANNEL_SLIDER4<<10) + (ADC_CHANNEL_BATT<<15); // conversions 7 and more
@@ -98,17 +120,17 @@ void adcInit()
   ADC1->SMPR1 = SAMPTIME + (SAMPTIME<<3) + (SAMPTIME<<6) + (SAMPTIME<<9) + (SAMPTIME<<12) + (SAMPTIME<<15) + (SAMPTIME<<18) + (SAMPTIME<<21) + (SAMPTIME<<24);
   ADC1->SMPR2 = SAMPTIME + (SAMPTIME<<3) + (SAMPTIME<<6) + (SAMPTIME<<9) + (SAMPTIME<<12) + (SAMPTIME<<15) + (SAMPTIME<<18) + (SAMPTIME<<21) + (SAMPTIME<<24) + (SAMPTIME<<27) ;
 
-  ADC->CCR = 0 ; //ADC_CCR_ADCPRE_0 ;             // Clock div 2
+  ADC->CCR = ADC_CCR_ADCPRE_0 ;                   // Clock div 4
 
-  DMA2_Stream0->CR = DMA_SxCR_PL | DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 | DMA_SxCR_MINC;
+  DMA2_Stream0->CR = DMA_SxCR_PL | DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 | DMA_SxCR_MINC | DMA_SxCR_CIRC | DMA_SxCR_HTIE | DMA_SxCR_TCIE;
   DMA2_Stream0->PAR = CONVERT_PTR_UINT(&ADC1->DR);
-  DMA2_Stream0->M0AR = CONVERT_PTR_UINT(Analog_values);
-  DMA2_Stream0->NDTR = NUMBER_ANALOG_ADC1;
+  DMA2_Stream0->M0AR = CONVERT_PTR_UINT(adc1Samples);
+  DMA2_Stream0->NDTR = 2*ADC_SCANS_PER_HALF*NUMBER_ANALOG_ADC1;
   DMA2_Stream0->FCR = DMA_SxFCR_DMDIS | DMA_SxFCR_FTH_0 ;
 
 #if defined(REV9E)
   ADC3->CR1 = ADC_CR1_SCAN ;
-  ADC3->CR2 = ADC_CR2_ADON | ADC_CR2_DMA | ADC_CR2_DDS ;
+  ADC3->CR2 = ADC_CR2_ADON | ADC_CR2_DMA | ADC_CR2_DDS | ADC_CR2_CONT ;
   ADC3->SQR1 = (NUMBER_ANALOG_ADC3-1) << 20 ;   // NUMBER_ANALOG Channels
   ADC3->SQR2 = 0; 
   ADC3->SQR3 = (ADC_CHANNEL_POT1<<0) + (ADC_CHANNEL_SLIDER1<<5) + (ADC_CHANNEL_SLIDER2<<10) ; // conversions 1 to 3
@@ -116,48 +138,99 @@ void adcInit()
   ADC3->SMPR2 = 0;
   
   // Enable the DMA channel here, DMA2 stream 1, channel 2
-  DMA2_Stream1->CR = DMA_SxCR_PL | DMA_SxCR_CHSEL_1 | DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 | DMA_SxCR_MINC;
+  DMA2_Stream1->CR = DMA_SxCR_PL | DMA_SxCR_CHSEL_1 | DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 | DMA_SxCR_MINC | DMA_SxCR_CIRC | DMA_SxCR_HTIE | DMA_SxCR_TCIE;
   DMA2_Stream1->PAR = CONVERT_PTR_UINT(&ADC3->DR);
-  DMA2_Stream1->M0AR = CONVERT_PTR_UINT(Analog_values + NUMBER_ANALOG_ADC1);
-  DMA2_Stream1->NDTR = NUMBER_ANALOG_ADC3;
+  DMA2_Stream1->M0AR = CONVERT_PTR_UINT(adc3Samples);
+  DMA2_Stream1->NDTR = 2*ADC_SCANS_PER_HALF*NUMBER_ANALOG_ADC3;
   DMA2_Stream1->FCR = DMA_SxFCR_DMDIS | DMA_SxFCR_FTH_0 ;
 #endif
-}
 
-void adcRead()
-{
-  DMA2_Stream0->CR &= ~DMA_SxCR_EN ;              // Disable DMA
   ADC1->SR &= ~(uint32_t) ( ADC_SR_EOC | ADC_SR_STRT | ADC_SR_OVR ) ;
   DMA2->LIFCR = DMA_LIFCR_CTCIF0 | DMA_LIFCR_CHTIF0 |DMA_LIFCR_CTEIF0 | DMA_LIFCR_CDMEIF0 | DMA_LIFCR_CFEIF0 ; // Write ones to clear bits
+  NVIC_EnableIRQ(DMA2_Stream0_IRQn);
+  NVIC_SetPriority(DMA2_Stream0_IRQn, 7);
   DMA2_Stream0->CR |= DMA_SxCR_EN ;               // Enable DMA
-  ADC1->CR2 |= (uint32_t)ADC_CR2_SWSTART ;
+  ADC1->CR2 |= (uint32_t)ADC_CR2_SWSTART ;        // Continuous conversions from now on
 
 #if defined(REV9E)
-  DMA2_Stream1->CR &= ~DMA_SxCR_EN ;    // Disable DMA
   ADC3->SR &= ~(uint32_t) ( ADC_SR_EOC | ADC_SR_STRT | ADC_SR_OVR ) ;
   DMA2->LIFCR = DMA_LIFCR_CTCIF1 | DMA_LIFCR_CHTIF1 |DMA_LIFCR_CTEIF1 | DMA_LIFCR_CDMEIF1 | DMA_LIFCR_CFEIF1 ; // Write ones to clear bits
+  NVIC_EnableIRQ(DMA2_Stream1_IRQn);
+  NVIC_SetPriority(DMA2_Stream1_IRQn, 7);
   DMA2_Stream1->CR |= DMA_SxCR_EN ;   // Enable DMA
   ADC3->CR2 |= (uint32_t)ADC_CR2_SWSTART ;
-#endif  // #if defined(REV9E)
+#endif
+}
 
-#if defined(REV9E)
-  for (unsigned int i=0; i<10000; i++) {
-    if ((DMA2->LISR & DMA_LISR_TCIF0) && (DMA2->LISR & DMA_LISR_TCIF1)) {
-      break;
+static uint16_t adcMedian(const uint16_t * scans, uint32_t count, uint32_t stride)
+{
+  uint16_t values[ADC_SCANS_PER_HALF];
+  for (uint32_t i=0; i<count; i++) {
+    uint16_t value = scans[i*stride];
+    uint32_t j = i;
+    for (; j>0 && values[j-1]>value; j--) {
+      values[j] = values[j-1];
     }
+    values[j] = value;
   }
-  DMA2_Stream0->CR &= ~DMA_SxCR_EN ;              // Disable DMA
-  DMA2_Stream1->CR &= ~DMA_SxCR_EN ;              // Disable DMA
-#else
-  for (unsigned int i=0; i<10000; i++) {
-    if (DMA2->LISR & DMA_LISR_TCIF0) {
-      break;
+  return (values[(count-1)/2] + values[count/2]) / 2;
+}
+
+// Filters count (up to ADC_SCANS_PER_HALF) consecutive scans of channels samples into Analog_values[first...]
+void adcFilterScans(const uint16_t * scans, uint32_t count, uint32_t first, uint32_t channels)
+{
+  for (uint32_t x=0; x<channels; x++) {
+    const uint16_t * samples = &scans[x];
+    uint16_t result;
+    if (adcFilterMode == ADC_FILTER_MEDIAN) {
+      result = adcMedian(samples, count, channels);
+    }
+    else if (adcFilterMode == ADC_FILTER_IIR) {
+      int32_t state = adcIirState[first+x];
+      if (!(adcIirInitialized & (1 << (first+x)))) {
+        adcIirInitialized |= (1 << (first+x));
+        state = samples[0] << IIR_FRAC;
+      }
+      for (uint32_t i=0; i<count; i++) {
+        state += ((samples[i*channels] << IIR_FRAC) - state) >> IIR_SHIFT;
+      }
+      adcIirState[first+x] = state;
+      result = state >> IIR_FRAC;
     }
+    else {
+      uint32_t sum = 0;
+      for (uint32_t i=0; i<count; i++) {
+        sum += samples[i*channels];
+      }
+      result = sum / count;
+    }
+    Analog_values[first+x] = result;
   }
-  DMA2_Stream0->CR &= ~DMA_SxCR_EN ;              // Disable DMA
-#endif
 }
 
+#if !defined(SIMU)
+// the other half of the buffer is written by the DMA while this one is filtered
+extern "C" void DMA2_Stream0_IRQHandler()
+{
+  TASKS_PROFILE_ISR();
+
+  uint32_t isr = DMA2->LISR;
+  DMA2->LIFCR = DMA_LIFCR_CTCIF0 | DMA_LIFCR_CHTIF0 | DMA_LIFCR_CTEIF0 | DMA_LIFCR_CDMEIF0 | DMA_LIFCR_CFEIF0;
+  adcFilterScans(adc1Samples[(isr & DMA_LISR_TCIF0) ? ADC_SCANS_PER_HALF : 0], ADC_SCANS_PER_HALF, 0, NUMBER_ANALOG_ADC1);
+}
+
+#if defined(REV9E)
+extern "C" void DMA2_Stream1_IRQHandler()
+{
+  TASKS_PROFILE_ISR();
+
+  uint32_t isr = DMA2->LISR;
+  DMA2->LIFCR = DMA_LIFCR_CTCIF1 | DMA_LIFCR_CHTIF1 | DMA_LIFCR_CTEIF1 | DMA_LIFCR_CDMEIF1 | DMA_LIFCR_CFEIF1;
+  adcFilterScans(adc3Samples[(isr & DMA_LISR_TCIF1) ? ADC_SCANS_PER_HALF : 0], ADC_SCANS_PER_HALF, NUMBER_ANALOG_ADC1, NUMBER_ANALOG_ADC3);
+}
+#endif
+#endif
+
 // TODO
 void adcStop()
 {
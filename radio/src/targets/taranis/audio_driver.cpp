@@ -157,6 +157,8 @@ extern "C" void TIM6_DAC_IRQHandler()
 
 extern "C" void DMA1_Stream5_IRQHandler()
 {
+  TASKS_PROFILE_ISR();
+
   DMA1_Stream5->CR &= ~DMA_SxCR_TCIE ;            // Stop interrupt
   DMA1->HIFCR = DMA_HIFCR_CTCIF5 | DMA_HIFCR_CHTIF5 | DMA_HIFCR_CTEIF5 | DMA_HIFCR_CDMEIF5 | DMA_HIFCR_CFEIF5 ; // Write ones to clear flags
   DMA1_Stream5->CR &= ~DMA_SxCR_EN ;                              // Disable DMA channel
@@ -108,6 +108,8 @@ void interrupt5ms()
 #if !defined(SIMU)
 extern "C" void INTERRUPT_5MS_IRQHandler()
 {
+  TASKS_PROFILE_ISR();
+
   INTERRUPT_5MS_TIMER->SR &= ~TIM_SR_UIF ;
   interrupt5ms() ;
 }
@@ -241,8 +241,15 @@ void watchdogInit(unsigned int duration);
 #endif
 
 // ADC driver
+enum AdcFilterMode {
+  ADC_FILTER_AVERAGE,
+  ADC_FILTER_MEDIAN,
+  ADC_FILTER_IIR
+};
+#define ADC_SCANS_PER_HALF  4
+extern uint8_t adcFilterMode;
 void adcInit(void);
-void adcRead(void);
+void adcFilterScans(const uint16_t * scans, uint32_t count, uint32_t first, uint32_t channels);
 inline uint16_t getAnalogValue(uint32_t value);
 
 #define BATT_SCALE    150
@@ -176,11 +176,21 @@ void lcdRefresh(bool wait)
     lcdInitFinish();
   }
 
+  uint32_t pages = lcdGetChangedPages();
+  if (!pages) {
+    // same frame as the one already displayed
+    return;
+  }
+
+  // the pages in between are sent as well, one DMA transfer is enough
+  uint32_t first = __builtin_ctz(pages);
+  uint32_t last = 31 - __builtin_clz(pages);
+
   //wait if previous DMA transfer still active
   WAIT_FOR_DMA_END();
   lcd_busy = true;
 
-  Set_Address(0, 0);
+  Set_Address(0, first);
 	
   LCD_NCS_LOW();
   LCD_A0_HIGH();
@@ -188,10 +198,14 @@ void lcdRefresh(bool wait)
   DMA1_Stream7->CR &= ~DMA_SxCR_EN ;    // Disable DMA
   DMA1->HIFCR = DMA_HIFCR_CTCIF7 | DMA_HIFCR_CHTIF7 | DMA_HIFCR_CTEIF7 | DMA_HIFCR_CDMEIF7 | DMA_HIFCR_CFEIF7 ; // Write ones to clear bits
 
+  DMA1_Stream7->M0AR = (uint32_t)&displayBuf[first * LCD_W];
+  DMA1_Stream7->NDTR = (last - first + 1) * LCD_W;
+
 #if defined(LCD_DUAL_BUFFER)
   //switch LCD buffer
-  DMA1_Stream7->M0AR = (uint32_t)displayBuf;
   displayBuf = (displayBuf == displayBuf1) ? displayBuf2 : displayBuf1;
+  // the other buffer holds an older frame, all its pages have to be checked again
+  lcdDirtyPages = LCD_ALL_PAGES;
 #endif
 
   DMA1_Stream7->CR |= DMA_SxCR_EN | DMA_SxCR_TCIE;		// Enable DMA & tXe interrupt
@@ -200,6 +214,8 @@ void lcdRefresh(bool wait)
 
 extern "C" void DMA1_Stream7_IRQHandler()
 {
+  TASKS_PROFILE_ISR();
+
   //clear interrupt flag
   DMA1_Stream7->CR &= ~DMA_SxCR_TCIE ;  // Stop interrupt
   DMA1->HIFCR |= DMA_HIFCR_CTCIF7;      // Clear interrupt flag
@@ -223,7 +239,13 @@ void lcdRefresh()
     lcdInitFinish();
   }
 
+  uint32_t pages = lcdGetChangedPages();
+
   for (uint32_t y=0; y<LCD_H; y++) {
+    if (!(pages & (1 << (y/2)))) {
+      continue;
+    }
+
     uint8_t *p = &displayBuf[y/2 * LCD_W];
 
     Set_Address(0, y);
@@ -411,6 +433,9 @@ void lcdInitFinish()
   LCD_Init();
   AspiCmd(0xAF);	//dc2=1, IC into exit SLEEP MODE, dc3=1 gray=ON, dc4=1 Green Enhanc mode disabled
   Delay(20);      //needed for internal DC-DC converter startup
+
+  // the LCD RAM content is unknown
+  lcdInvalidatePages();
 }
 
 void lcdSetRefVolt(uint8_t val)
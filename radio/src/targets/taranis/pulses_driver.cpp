@@ -59,6 +59,39 @@ static void intmoduleNoneStop( void ) ;
 static void extmoduleNoneStart( void ) ;
 static void extmoduleNoneStop( void ) ;
 
+// With PXX and DSM2 the frame period is fixed: the compare 2, which latches the next frame at the
+// update time, first fires a bit earlier to wake the mixer up, so that the latched outputs are fresh
+#define MIXER_WAKEUP_MARGIN      400   // 200us for the scheduler and the other interrupts
+#define MIXER_WAKEUP_MAX_LEAD    6000  // 3ms
+
+static uint16_t intmoduleUpdateTime = 0; // 0 when the mixer is not synchronized on the module
+static uint16_t extmoduleUpdateTime = 0;
+
+#if !defined(SIMU)
+static void scheduleMixerWakeup(TIM_TypeDef * timer, uint16_t updateTime)
+{
+  uint16_t lead = lastMixerDuration + MIXER_WAKEUP_MARGIN;
+  if (lead > MIXER_WAKEUP_MAX_LEAD) lead = MIXER_WAKEUP_MAX_LEAD;
+  timer->CCR2 = updateTime - lead;
+}
+
+// returns true when the compare was the mixer wakeup one
+static bool mixerWakeup(TIM_TypeDef * timer, uint16_t updateTime)
+{
+  if (updateTime == 0 || timer->CCR2 == updateTime) {
+    return false;
+  }
+
+  timer->SR &= ~TIM_SR_CC2IF;
+  timer->CCR2 = updateTime;
+  CoEnterISR();
+  TASKS_PROFILE_MIXER_WAKEUP();
+  isr_SetFlag(mixerFlag);
+  CoExitISR();
+  return true;
+}
+#endif
+
 void init_pxx(uint32_t port)
 {
   if (port == INTERNAL_MODULE)
@@ -246,6 +279,7 @@ static void intmodulePxxStart()
   INTMODULE_TIMER->CR1 &= ~TIM_CR1_CEN ;
   INTMODULE_TIMER->ARR = 18000 ;                     // 9mS
   INTMODULE_TIMER->CCR2 = 15000 ;            // Update time
+  intmoduleUpdateTime = 15000 ;
   INTMODULE_TIMER->PSC = (PERI2_FREQUENCY * TIMER_MULT_APB2) / 2000000 - 1 ;               // 0.5uS from 30MHz
   INTMODULE_TIMER->CCER = TIM_CCER_CC3E ;
   INTMODULE_TIMER->CR2 = TIM_CR2_OIS3 ;              // O/P idle high
@@ -278,6 +312,7 @@ static void intmodulePxxStop()
   DMA2_Stream6->CR &= ~DMA_SxCR_EN ;              // Disable DMA
   NVIC_DisableIRQ(TIM1_CC_IRQn) ;
   INTMODULE_TIMER->DIER &= ~TIM_DIER_CC2IE ;
+  intmoduleUpdateTime = 0 ;
   INTMODULE_TIMER->CR1 &= ~TIM_CR1_CEN ;
   INTERNAL_MODULE_OFF();
 }
@@ -336,6 +371,12 @@ static void intmodulePpmStop()
 #if !defined(SIMU)
 extern "C" void TIM1_CC_IRQHandler()
 {
+  TASKS_PROFILE_ISR();
+
+  if (mixerWakeup(INTMODULE_TIMER, intmoduleUpdateTime)) {
+    return;
+  }
+
   INTMODULE_TIMER->DIER &= ~TIM_DIER_CC2IE;       // stop this interrupt
   INTMODULE_TIMER->SR &= ~TIM_SR_CC2IF;           // clear flag
   DMA2_Stream6->CR &= ~DMA_SxCR_EN;    // disable DMA, it will have the whole of the execution time of setupPulses() to actually stop
@@ -347,6 +388,7 @@ extern "C" void TIM1_CC_IRQHandler()
     DMA2_Stream6->M0AR = CONVERT_PTR_UINT(&modulePulsesData[INTERNAL_MODULE].pxx.pulses[1]);
     DMA2_Stream6->CR |= DMA_SxCR_EN;   // enable DMA
     INTMODULE_TIMER->CCR3 = modulePulsesData[INTERNAL_MODULE].pxx.pulses[0];
+    scheduleMixerWakeup(INTMODULE_TIMER, intmoduleUpdateTime);
     INTMODULE_TIMER->DIER |= TIM_DIER_CC2IE;      // enable this interrupt
   }
 #if defined(TARANIS_INTERNAL_PPM)
@@ -392,6 +434,7 @@ void extmodulePxxStart()
   EXTMODULE_TIMER->CR1 &= ~TIM_CR1_CEN ;
   EXTMODULE_TIMER->ARR = 18000 ;                     // 9mS
   EXTMODULE_TIMER->CCR2 = 15000 ;            // Update time
+  extmoduleUpdateTime = 15000 ;
   EXTMODULE_TIMER->PSC = (PERI2_FREQUENCY * TIMER_MULT_APB2) / 2000000 - 1 ;               // 0.5uS from 30MHz
   EXTMODULE_TIMER->CCER = TIM_CCER_CC1NE ;
   EXTMODULE_TIMER->CR2 = TIM_CR2_OIS1 ;                      // O/P idle high
@@ -427,6 +470,7 @@ static void extmodulePxxStop()
   DMA2_Stream2->CR &= ~DMA_SxCR_EN ;              // Disable DMA
   NVIC_DisableIRQ(EXTMODULE_TIMER_IRQn) ;
   EXTMODULE_TIMER->DIER &= ~TIM_DIER_CC2IE ;
+  extmoduleUpdateTime = 0 ;
   EXTMODULE_TIMER->CR1 &= ~TIM_CR1_CEN ;
   if (!IS_TRAINER_EXTERNAL_MODULE()) {
     EXTERNAL_MODULE_OFF();
@@ -452,6 +496,7 @@ static void extmoduleDsm2Start()
   EXTMODULE_TIMER->CR1 &= ~TIM_CR1_CEN ;
   EXTMODULE_TIMER->ARR = 44000 ;                     // 22mS
   EXTMODULE_TIMER->CCR2 = 40000 ;            // Update time
+  extmoduleUpdateTime = 40000 ;
   EXTMODULE_TIMER->PSC = (PERI2_FREQUENCY * TIMER_MULT_APB2) / 2000000 - 1 ;               // 0.5uS from 30MHz
   EXTMODULE_TIMER->CCER = TIM_CCER_CC1NE  | TIM_CCER_CC1NP ;
   EXTMODULE_TIMER->CR2 = TIM_CR2_OIS1 ;                      // O/P idle high
@@ -487,6 +532,7 @@ static void extmoduleDsm2Stop()
   DMA2_Stream2->CR &= ~DMA_SxCR_EN ;              // Disable DMA
   NVIC_DisableIRQ(EXTMODULE_TIMER_IRQn) ;
   EXTMODULE_TIMER->DIER &= ~TIM_DIER_CC2IE ;
+  extmoduleUpdateTime = 0 ;
   EXTMODULE_TIMER->CR1 &= ~TIM_CR1_CEN ;
   if (!IS_TRAINER_EXTERNAL_MODULE()) {
     EXTERNAL_MODULE_OFF();
@@ -543,6 +589,12 @@ static void extmodulePpmStop()
 #if !defined(SIMU)
 extern "C" void TIM8_CC_IRQHandler()
 {
+  TASKS_PROFILE_ISR();
+
+  if (mixerWakeup(EXTMODULE_TIMER, extmoduleUpdateTime)) {
+    return;
+  }
+
   EXTMODULE_TIMER->DIER &= ~TIM_DIER_CC2IE ;         // stop this interrupt
   EXTMODULE_TIMER->SR &= ~TIM_SR_CC2IF ;                             // Clear flag
 
@@ -554,6 +606,7 @@ extern "C" void TIM8_CC_IRQHandler()
     DMA2_Stream2->M0AR = CONVERT_PTR_UINT(&modulePulsesData[EXTERNAL_MODULE].pxx.pulses[1]);
     DMA2_Stream2->CR |= DMA_SxCR_EN ;               // Enable DMA
     EXTMODULE_TIMER->CCR1 = modulePulsesData[EXTERNAL_MODULE].pxx.pulses[0];
+    scheduleMixerWakeup(EXTMODULE_TIMER, extmoduleUpdateTime);
     EXTMODULE_TIMER->DIER |= TIM_DIER_CC2IE ;  // Enable this interrupt
   }
 #if defined(DSM2)
@@ -563,6 +616,7 @@ extern "C" void TIM8_CC_IRQHandler()
     DMA2_Stream2->M0AR = CONVERT_PTR_UINT(&modulePulsesData[EXTERNAL_MODULE].dsm2.pulses[1]);
     DMA2_Stream2->CR |= DMA_SxCR_EN ;               // Enable DMA
     EXTMODULE_TIMER->CCR1 = modulePulsesData[EXTERNAL_MODULE].dsm2.pulses[0];
+    scheduleMixerWakeup(EXTMODULE_TIMER, extmoduleUpdateTime);
     EXTMODULE_TIMER->DIER |= TIM_DIER_CC2IE ;  // Enable this interrupt
   }
 #endif
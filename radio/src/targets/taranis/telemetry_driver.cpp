@@ -74,6 +74,7 @@ void telemetryPortInit(uint32_t baudrate)
   USART_Init(TELEMETRY_USART, &USART_InitStructure);
   USART_Cmd(TELEMETRY_USART, ENABLE);
   USART_ITConfig(TELEMETRY_USART, USART_IT_RXNE, ENABLE);
+  USART_ITConfig(TELEMETRY_USART, USART_IT_IDLE, ENABLE);
 
   NVIC_SetPriority(TELEMETRY_USART_IRQn, 6);
   NVIC_EnableIRQ(TELEMETRY_USART_IRQn);
@@ -99,6 +100,8 @@ void sportSendBuffer(uint8_t *buffer, uint32_t count)
 
 extern "C" void TELEMETRY_USART_IRQHandler()
 {
+  TASKS_PROFILE_ISR();
+
   uint32_t status;
   uint8_t data;
 
@@ -124,6 +127,12 @@ extern "C" void TELEMETRY_USART_IRQHandler()
     }
   }
 	
+  // the line is idle after a frame, the frame is complete in the fifo
+  bool idle = (status & USART_SR_IDLE);
+  if (idle && !(status & USART_FLAG_RXNE)) {
+    data = TELEMETRY_USART->DR; // clears IDLE
+  }
+
   while (status & (USART_FLAG_RXNE | USART_FLAG_ERRORS)) {
     data = TELEMETRY_USART->DR;
     if (!(status & USART_FLAG_ERRORS)) {
@@ -131,5 +140,11 @@ extern "C" void TELEMETRY_USART_IRQHandler()
     }
     status = TELEMETRY_USART->SR;
   }
+
+  if (idle) {
+    CoEnterISR();
+    isr_SetFlag(telemetryFlag);
+    CoExitISR();
+  }
 }
 #endif
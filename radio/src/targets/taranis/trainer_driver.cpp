@@ -120,6 +120,8 @@ void stop_trainer_capture()
 #if !defined(SIMU)
 extern "C" void TIM3_IRQHandler()
 {
+  TASKS_PROFILE_ISR();
+
   uint16_t capture = 0;
   bool doCapture = false ;
 
@@ -127,6 +127,8 @@ void uart3Stop()
 #if !defined(SIMU)
 extern "C" void SERIAL_USART_IRQHandler(void)
 {
+  TASKS_PROFILE_ISR();
+
   // Send
   if (USART_GetITStatus(SERIAL_USART, USART_IT_TXE) != RESET) {
     uint8_t txchar;
@@ -41,6 +41,9 @@
 #define AUDIO_STACK_SIZE    500
 #define BT_STACK_SIZE       500
 #define DEBUG_STACK_SIZE    500
+#define TELEMETRY_STACK_SIZE 500
+#define LOGS_STACK_SIZE     500
+#define LUA_STACK_SIZE      1000
 
 #if defined(_MSC_VER)
   #define _ALIGNED(x) __declspec(align(x))
@@ -58,6 +61,11 @@ OS_STK mixerStack[MIXER_STACK_SIZE];
 OS_TID audioTaskId;
 OS_STK audioStack[AUDIO_STACK_SIZE];
 
+#if defined(LUA)
+OS_TID luaMixTaskId;
+OS_STK _ALIGNED(8) luaMixStack[LUA_STACK_SIZE];
+#endif
+
 #if defined(BLUETOOTH)
 OS_TID btTaskId;
 OS_STK btStack[BT_STACK_SIZE];
@@ -68,8 +76,24 @@ OS_TID debugTaskId;
 OS_STK debugStack[DEBUG_STACK_SIZE];
 #endif
 
+#if defined(FRSKY) || defined(MAVLINK)
+OS_TID telemetryTaskId;
+OS_STK telemetryStack[TELEMETRY_STACK_SIZE];
+#endif
+
+OS_TID logsTaskId;
+OS_STK logsStack[LOGS_STACK_SIZE];
+
 OS_MutexID audioMutex;
 OS_MutexID mixerMutex;
+OS_FlagID mixerFlag;
+OS_FlagID telemetryFlag;
+OS_MutexID logsMutex;
+OS_FlagID logsFlag;
+#if defined(LUA)
+OS_MutexID luaMutex;
+OS_FlagID luaMixFlag;
+#endif
 
 void stack_paint()
 {
@@ -79,6 +103,24 @@ void stack_paint()
     mixerStack[i] = 0x55555555;
   for (uint32_t i=0; i<AUDIO_STACK_SIZE; i++)
     audioStack[i] = 0x55555555;
+#if defined(LUA)
+  for (uint32_t i=0; i<LUA_STACK_SIZE; i++)
+    luaMixStack[i] = 0x55555555;
+#endif
+#if defined(BLUETOOTH)
+  for (uint32_t i=0; i<BT_STACK_SIZE; i++)
+    btStack[i] = 0x55555555;
+#endif
+#if defined(DEBUG)
+  for (uint32_t i=0; i<DEBUG_STACK_SIZE; i++)
+    debugStack[i] = 0x55555555;
+#endif
+#if defined(FRSKY) || defined(MAVLINK)
+  for (uint32_t i=0; i<TELEMETRY_STACK_SIZE; i++)
+    telemetryStack[i] = 0x55555555;
+#endif
+  for (uint32_t i=0; i<LOGS_STACK_SIZE; i++)
+    logsStack[i] = 0x55555555;
 }
 
 uint32_t stack_free(uint32_t tid)
@@ -99,6 +141,34 @@ uint32_t stack_free(uint32_t tid)
       stack = audioStack;
       size = AUDIO_STACK_SIZE;
       break;
+#if defined(LUA)
+    case 3:
+      stack = luaMixStack;
+      size = LUA_STACK_SIZE;
+      break;
+#endif
+#if defined(BLUETOOTH)
+    case 4:
+      stack = btStack;
+      size = BT_STACK_SIZE;
+      break;
+#endif
+#if defined(DEBUG)
+    case 5:
+      stack = debugStack;
+      size = DEBUG_STACK_SIZE;
+      break;
+#endif
+#if defined(FRSKY) || defined(MAVLINK)
+    case 6:
+      stack = telemetryStack;
+      size = TELEMETRY_STACK_SIZE;
+      break;
+#endif
+    case 7:
+      stack = logsStack;
+      size = LOGS_STACK_SIZE;
+      break;
 #if defined(PCBTARANIS)
     case 255:
   #if defined(SIMU)
@@ -136,8 +206,12 @@ void mixerTask(void * pdata)
       doMixerCalculations();
       CoLeaveMutexSection(mixerMutex);
 
-#if defined(FRSKY) || defined(MAVLINK)
-      telemetryWakeup();
+      MIXER_PROFILE_END();
+
+#if defined(LUA)
+      if (luaMixScriptsDue()) {
+        CoSetFlag(luaMixFlag);
+      }
 #endif
 
       if (heartbeat == HEART_WDT_CHECK) {
@@ -146,10 +220,55 @@ void mixerTask(void * pdata)
       }
 
       t0 = getTmr2MHz() - t0;
+      lastMixerDuration = t0;
       if (t0 > maxMixerDuration) maxMixerDuration = t0 ;
     }
 
-    CoTickDelay(1);  // 2ms for now
+    // the module driver sets the flag just before the module latches its next frame,
+    // the timeout keeps the 2ms period when it doesn't (PPM, Sky9x)
+    CoWaitForSingleFlag(mixerFlag, 1);
+    TASKS_PROFILE_MIXER_RUNNING();
+  }
+}
+
+#if defined(LUA)
+// the mix scripts run right after the mixer cycle which woke them up, their outputs don't
+// depend on how busy the menus are. The interpreter is shared with the menus task, the
+// longest wait is one menus Lua run, which is bounded by the instructions budget
+void luaMixTask(void * pdata)
+{
+  while (1) {
+    CoWaitForSingleFlag(luaMixFlag, 0);
+    luaRunMixScripts();
+  }
+}
+#endif
+
+#if defined(FRSKY) || defined(MAVLINK)
+#define TELEMETRY_TASK_PERIOD_TICKS 5     // 10ms
+
+// the frames are decoded out of the mixer task, the mixer cycle doesn't get longer when more
+// telemetry arrives. The driver sets the flag when the line goes idle after a frame, the
+// timeout covers the ports without idle detection. The decoding is done with the mixer paused,
+// but telemetryWakeup() decodes a bounded number of bytes at each call
+void telemetryTask(void * pdata)
+{
+  while (1) {
+    CoWaitForSingleFlag(telemetryFlag, TELEMETRY_TASK_PERIOD_TICKS);
+    CoEnterMutexSection(mixerMutex);
+    telemetryWakeup();
+    CoLeaveMutexSection(mixerMutex);
+  }
+}
+#endif
+
+// the logs are written to the SD card below the menus priority, perMain() doesn't wait for
+// a slow card. writeLogs() sets the flag when at least a sector is buffered
+void logsTask(void * pdata)
+{
+  while (1) {
+    CoWaitForSingleFlag(logsFlag, 0);
+    flushLogs();
   }
 }
 
@@ -173,6 +292,7 @@ void menusTask(void * pdata)
 #endif
     U64 start = CoGetOSTime();
     perMain();
+    TASKS_PROFILE_UPDATE();
     // TODO remove completely massstorage from sky9x firmware
     U32 runtime = (U32)(CoGetOSTime() - start);
     // deduct the thread run-time from the wait, if run-time was more than 
@@ -210,21 +330,52 @@ void tasksStart()
 {
   CoInitOS();
 
+  mixerFlag = CoCreateFlag(true, false);  // auto-reset
+#if defined(FRSKY) || defined(MAVLINK)
+  telemetryFlag = CoCreateFlag(true, false);  // auto-reset
+#endif
+#if defined(LUA)
+  luaMixFlag = CoCreateFlag(true, false);  // auto-reset
+#endif
+  logsFlag = CoCreateFlag(true, false);  // auto-reset
+
+  TASKS_PROFILE_REGISTER(0, "Idle", TASKS_PROFILE_NO_STACK);
+  TASKS_PROFILE_REGISTER(TASKS_PROFILE_ISR_SLOT, "ISRs", 255);
+
 #if defined(CPUARM) && defined(DEBUG) && !defined(SIMU)
   debugTaskId = CoCreateTaskEx(debugTask, NULL, 10, &debugStack[DEBUG_STACK_SIZE-1], DEBUG_STACK_SIZE, 1, false);
+  TASKS_PROFILE_REGISTER(debugTaskId, "Debug", 5);
 #endif
 
 #if defined(BLUETOOTH)
   btTaskId = CoCreateTask(btTask, NULL, 15, &btStack[BT_STACK_SIZE-1], BT_STACK_SIZE);
+  TASKS_PROFILE_REGISTER(btTaskId, "Bluetooth", 4);
 #endif
 
   mixerTaskId = CoCreateTask(mixerTask, NULL, 5, &mixerStack[MIXER_STACK_SIZE-1], MIXER_STACK_SIZE);
+  TASKS_PROFILE_REGISTER(mixerTaskId, "Mixer", 1);
   menusTaskId = CoCreateTask(menusTask, NULL, 10, &menusStack[MENUS_STACK_SIZE-1], MENUS_STACK_SIZE);
+  TASKS_PROFILE_REGISTER(menusTaskId, "Menus", 0);
   audioTaskId = CoCreateTask(audioTask, NULL, 7, &audioStack[AUDIO_STACK_SIZE-1], AUDIO_STACK_SIZE);
+  TASKS_PROFILE_REGISTER(audioTaskId, "Audio", 2);
+#if defined(LUA)
+  luaMixTaskId = CoCreateTask(luaMixTask, NULL, 8, &luaMixStack[LUA_STACK_SIZE-1], LUA_STACK_SIZE);
+  TASKS_PROFILE_REGISTER(luaMixTaskId, "Lua mix", 3);
+#endif
+#if defined(FRSKY) || defined(MAVLINK)
+  telemetryTaskId = CoCreateTask(telemetryTask, NULL, 9, &telemetryStack[TELEMETRY_STACK_SIZE-1], TELEMETRY_STACK_SIZE);
+  TASKS_PROFILE_REGISTER(telemetryTaskId, "Telemetry", 6);
+#endif
+  logsTaskId = CoCreateTask(logsTask, NULL, 11, &logsStack[LOGS_STACK_SIZE-1], LOGS_STACK_SIZE);
+  TASKS_PROFILE_REGISTER(logsTaskId, "Logs", 7);
 
 #if !defined(SIMU)
   audioMutex = CoCreateMutex();
   mixerMutex = CoCreateMutex();
+  logsMutex = CoCreateMutex();
+#if defined(LUA)
+  luaMutex = CoCreateMutex();
+#endif
 #endif
 
   CoStartOS();
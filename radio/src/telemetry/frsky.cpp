@@ -279,6 +279,8 @@ NOINLINE void processSerialData(uint8_t data)
 #endif
 }
 
+#define TELEMETRY_WAKEUP_MAX_BYTES  64 // more than what the S.PORT brings in 10ms
+
 void telemetryWakeup()
 {
 #if defined(CPUARM)
@@ -291,13 +293,15 @@ void telemetryWakeup()
 
 #if defined(PCBTARANIS)
   uint8_t data;
+  // bounded, the mixer waits for the decoding of at most these bytes
+  uint8_t count = TELEMETRY_WAKEUP_MAX_BYTES;
 #if defined(SPORT_FILE_LOG) && !defined(SIMU)
   static tmr10ms_t lastTime = 0;
   tmr10ms_t newTime = get_tmr10ms();
   struct gtm utm;
   gettime(&utm);
 #endif
-  while (telemetryFifo.pop(data)) {
+  while (count-- > 0 && telemetryFifo.pop(data)) {
     processSerialData(data);
 #if defined(SPORT_FILE_LOG) && !defined(SIMU)
     extern FIL g_telemetryFile;
@@ -337,12 +341,7 @@ void telemetryWakeup()
 #endif
 
 #if defined(CPUARM)
-  for (int i=0; i<MAX_SENSORS; i++) {
-    const TelemetrySensor & sensor = g_model.telemetrySensors[i];
-    if (sensor.type == TELEM_TYPE_CALCULATED) {
-      telemetryItems[i].eval(sensor);
-    }
-  }
+  evalCalculatedTelemetrySensors();
 #endif
 
 #if defined(VARIO)
@@ -369,7 +368,7 @@ void telemetryWakeup()
       if (isTelemetryFieldAvailable(i)) {
         uint8_t lastReceived = telemetryItems[i].lastReceived;
         if (lastReceived < TELEMETRY_VALUE_TIMER_CYCLE && uint8_t(now - lastReceived) > TELEMETRY_VALUE_OLD_THRESHOLD) {
-          telemetryItems[i].lastReceived = TELEMETRY_VALUE_OLD;
+          telemetryItems[i].setOld();
           TelemetrySensor * sensor = & g_model.telemetrySensors[i];
           if (sensor->unit == UNIT_DATETIME) {
             telemetryItems[i].datetime.datestate = 0;
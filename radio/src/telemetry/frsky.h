@@ -485,6 +485,8 @@ enum FrSkyDataState {
   }
 #endif
 
+void processSerialData(uint8_t data);
+
 // FrSky D Protocol
 void processHubPacket(uint8_t id, int16_t value);
 void frskyDSendNextAlarm(void);
@@ -492,6 +494,17 @@ void frskyDProcessPacket(uint8_t *packet);
 
 // FrSky S.PORT Protocol
 void processSportPacket(uint8_t *packet);
+#if defined(CPUARM)
+struct FrSkySportSensor {
+  const uint16_t firstId;
+  const uint16_t lastId;
+  const char * name;
+  const TelemetryUnit unit;
+  const uint8_t prec;
+};
+extern const FrSkySportSensor sportSensors[];
+const FrSkySportSensor * getFrSkySportSensor(uint16_t id);
+#endif
 #if defined(PCBTARANIS)
 void sportFirmwareUpdate(ModuleIndex module, const char *filename);
 #endif
@@ -2,6 +2,31 @@
 
 TelemetryItem telemetryItems[MAX_SENSORS];
 
+#define SENSOR_BIT(idx)  ((uint32_t)1 << (idx))
+
+// the sensors which changed since the last evaluation of the calculated sensors, also set from the 10ms interrupt
+static volatile uint32_t telemetrySensorsUpdated;
+
+static void setTelemetryItemUpdated(const TelemetryItem * item)
+{
+  unsigned int index = item - telemetryItems;
+  if (index < MAX_SENSORS) {
+    __disable_irq();
+    telemetrySensorsUpdated |= SENSOR_BIT(index);
+    __enable_irq();
+  }
+}
+
+// the bits are read and cleared with the interrupts disabled, the 10ms interrupt sets them too
+static uint32_t takeTelemetrySensorsUpdated()
+{
+  __disable_irq();
+  uint32_t result = telemetrySensorsUpdated;
+  telemetrySensorsUpdated = 0;
+  __enable_irq();
+  return result;
+}
+
 void TelemetryItem::gpsReceived()
 {
   if (!distFromEarthAxis) {
@@ -18,6 +43,8 @@ void TelemetryItem::setValue(const TelemetrySensor & sensor, int32_t val, uint32
 {
   int32_t newVal = val;
 
+  setTelemetryItemUpdated(this);
+
   if (unit == UNIT_CELLS) {
     uint32_t data = uint32_t(newVal);
     uint8_t cellsCount = (data >> 24);
@@ -255,6 +282,12 @@ bool TelemetryItem::isOld()
   return (lastReceived == TELEMETRY_VALUE_OLD);
 }
 
+void TelemetryItem::setOld()
+{
+  lastReceived = TELEMETRY_VALUE_OLD;
+  setTelemetryItemUpdated(this);
+}
+
 void TelemetryItem::per10ms(const TelemetrySensor & sensor)
 {
   switch (sensor.formula) {
@@ -266,7 +299,7 @@ void TelemetryItem::per10ms(const TelemetrySensor & sensor)
           return;
         }
         else if (currentItem.isOld()) {
-          lastReceived = TELEMETRY_VALUE_OLD;
+          setOld();
           return;
         }
         int32_t current = convertTelemetryValue(currentItem.value, currentSensor.unit, currentSensor.prec, UNIT_AMPS, 1);
@@ -276,6 +309,7 @@ void TelemetryItem::per10ms(const TelemetrySensor & sensor)
           setValue(sensor, value+1, sensor.unit, sensor.prec);
         }
         lastReceived = now();
+        setTelemetryItemUpdated(this);
       }
       break;
 
@@ -291,7 +325,7 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
       if (sensor.cell.source) {
         TelemetryItem & cellsItem = telemetryItems[sensor.cell.source-1];
         if (cellsItem.isOld()) {
-          lastReceived = TELEMETRY_VALUE_OLD;
+          setOld();
         }
         else {
           unsigned int index = sensor.cell.index;
@@ -340,7 +374,7 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
           return;
         }
         else if (gpsItem.isOld()) {
-          lastReceived = TELEMETRY_VALUE_OLD;
+          setOld();
           return;
         }
         if (sensor.dist.alt) {
@@ -349,7 +383,7 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
             return;
           }
           else if (altItem->isOld()) {
-            lastReceived = TELEMETRY_VALUE_OLD;
+            setOld();
             return;
           }
         }
@@ -406,7 +440,7 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
               return;
             }
             else if (telemetryItem.isOld()) {
-              lastReceived = TELEMETRY_VALUE_OLD;
+              setOld();
               return;
             }
           }
@@ -432,7 +466,7 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
       if (sensor.formula == TELEM_FORMULA_AVERAGE) {
         if (count == 0) {
           if (available)
-            lastReceived = TELEMETRY_VALUE_OLD;
+            setOld();
           return;
         }
         else {
@@ -453,10 +487,144 @@ void TelemetryItem::eval(const TelemetrySensor & sensor)
   }
 }
 
+// the sensors read by a sensor, a bit for each slot
+uint32_t getTelemetrySensorInputs(const TelemetrySensor & sensor)
+{
+  uint32_t result = 0;
+
+  if (sensor.type == TELEM_TYPE_CALCULATED) {
+    uint8_t sources[4] = { 0, 0, 0, 0 };
+    switch (sensor.formula) {
+      case TELEM_FORMULA_CELL:
+        sources[0] = sensor.cell.source;
+        break;
+      case TELEM_FORMULA_DIST:
+        sources[0] = sensor.dist.gps;
+        sources[1] = sensor.dist.alt;
+        break;
+      case TELEM_FORMULA_TOTALIZE:
+      case TELEM_FORMULA_CONSUMPTION:
+        sources[0] = sensor.consumption.source;
+        break;
+      case TELEM_FORMULA_MULTIPLY:
+        sources[0] = abs(sensor.calc.sources[0]);
+        sources[1] = abs(sensor.calc.sources[1]);
+        break;
+      default:
+        for (int i=0; i<4; i++) {
+          sources[i] = abs(sensor.calc.sources[i]);
+        }
+        break;
+    }
+    for (int i=0; i<4; i++) {
+      if (sources[i] > 0 && sources[i] <= MAX_SENSORS) {
+        result |= SENSOR_BIT(sources[i]-1);
+      }
+    }
+  }
+
+  return result;
+}
+
+bool isTelemetrySensorReading(uint8_t index, uint8_t source)
+{
+  uint32_t reached = SENSOR_BIT(index);
+  uint32_t added = reached;
+
+  while (added) {
+    uint32_t inputs = 0;
+    for (int i=0; i<MAX_SENSORS; i++) {
+      if (added & SENSOR_BIT(i)) {
+        inputs |= getTelemetrySensorInputs(g_model.telemetrySensors[i]);
+      }
+    }
+    added = inputs & ~reached;
+    reached |= added;
+  }
+
+  return (reached & SENSOR_BIT(source));
+}
+
+// The calculated sensors sorted so that each one comes after the sensors it reads, they all see
+// the values of the same cycle. Built when the model changes, like the logical switches graph
+struct TelemetrySensorsGraph {
+  uint32_t inputs[MAX_SENSORS];
+  uint8_t order[MAX_SENSORS];
+  uint8_t count;
+};
+
+static TelemetrySensorsGraph telemetrySensorsGraph;
+bool telemetrySensorsGraphDirty = true;
+
+static void buildTelemetrySensorsGraph()
+{
+  telemetrySensorsGraphDirty = false;
+
+  // the totalize and consumption sensors are not evaluated here, they follow their source
+  uint32_t remaining = 0;
+  for (int i=0; i<MAX_SENSORS; i++) {
+    const TelemetrySensor & sensor = g_model.telemetrySensors[i];
+    telemetrySensorsGraph.inputs[i] = getTelemetrySensorInputs(sensor);
+    if (sensor.type == TELEM_TYPE_CALCULATED && sensor.formula != TELEM_FORMULA_TOTALIZE && sensor.formula != TELEM_FORMULA_CONSUMPTION) {
+      remaining |= SENSOR_BIT(i);
+    }
+  }
+
+  uint8_t count = 0;
+  while (remaining) {
+    bool placed = false;
+    for (int i=0; i<MAX_SENSORS; i++) {
+      if ((remaining & SENSOR_BIT(i)) && !(telemetrySensorsGraph.inputs[i] & remaining)) {
+        telemetrySensorsGraph.order[count++] = i;
+        remaining &= ~SENSOR_BIT(i);
+        placed = true;
+      }
+    }
+    if (!placed) {
+      // a loop which the menus don't allow (older firmware, Companion), these ones are evaluated
+      // in slot order and see the previous values of the sensors after them
+      for (int i=0; i<MAX_SENSORS; i++) {
+        if (remaining & SENSOR_BIT(i)) {
+          telemetrySensorsGraph.order[count++] = i;
+        }
+      }
+      break;
+    }
+  }
+  telemetrySensorsGraph.count = count;
+
+  telemetrySensorsUpdated = (uint32_t)-1;
+}
+
+/**
+  @brief Evaluates the calculated sensors
+
+  Only the sensors whose inputs got a value or became old since the last evaluation are evaluated
+  again, in dependency order.
+*/
+void evalCalculatedTelemetrySensors()
+{
+  if (telemetrySensorsGraphDirty) {
+    buildTelemetrySensorsGraph();
+  }
+
+  // the sensors evaluated here update their dependents further in the order
+  uint32_t updated = 0;
+  for (uint8_t i=0; i<telemetrySensorsGraph.count; i++) {
+    uint8_t index = telemetrySensorsGraph.order[i];
+    updated |= takeTelemetrySensorsUpdated();
+    if (telemetrySensorsGraph.inputs[index] & updated) {
+      telemetryItems[index].eval(g_model.telemetrySensors[index]);
+    }
+  }
+}
+
 void delTelemetryIndex(uint8_t index)
 {
   memclear(&g_model.telemetrySensors[index], sizeof(TelemetrySensor));
   telemetryItems[index].clear();
+  telemetrySensorsIndexDirty = true;
+  telemetrySensorsGraphDirty = true;
   eeDirty(EE_MODEL);
 }
 
@@ -482,8 +650,82 @@ int lastUsedTelemetryIndex()
   return -1;
 }
 
+// The custom sensors sorted by id and instance, an incoming value finds its sensors without
+// scanning the whole table. Rebuilt on the next value after INVALIDATE_MIXER_PROGRAM()
+struct TelemetrySensorsIndexEntry {
+  uint16_t id;
+  uint8_t instance;
+  uint8_t index;
+};
+
+static TelemetrySensorsIndexEntry telemetrySensorsIndex[MAX_SENSORS];
+static uint8_t telemetrySensorsIndexCount;
+bool telemetrySensorsIndexDirty = true;
+
+static void buildTelemetrySensorsIndex()
+{
+  // cleared first, a change of the sensors during the build sets it again
+  telemetrySensorsIndexDirty = false;
+
+  uint8_t count = 0;
+  for (int index=0; index<MAX_SENSORS; index++) {
+    TelemetrySensor & telemetrySensor = g_model.telemetrySensors[index];
+    if (telemetrySensor.type == TELEM_TYPE_CUSTOM) {
+      TelemetrySensorsIndexEntry entry = { telemetrySensor.id, telemetrySensor.instance, (uint8_t)index };
+      // insertion sort, the sensors with the same id and instance stay in their order
+      int i = count++;
+      for (; i>0; i--) {
+        const TelemetrySensorsIndexEntry & previous = telemetrySensorsIndex[i-1];
+        if (previous.id < entry.id || (previous.id == entry.id && previous.instance <= entry.instance)) {
+          break;
+        }
+        telemetrySensorsIndex[i] = previous;
+      }
+      telemetrySensorsIndex[i] = entry;
+    }
+  }
+  telemetrySensorsIndexCount = count;
+}
+
+static bool setIndexedTelemetryValue(uint16_t id, uint8_t instance, int32_t value, uint32_t unit, uint32_t prec)
+{
+  bool available = false;
+
+  if (telemetrySensorsIndexDirty) {
+    buildTelemetrySensorsIndex();
+  }
+
+  // first entry with this id
+  int first = 0, last = telemetrySensorsIndexCount;
+  while (first < last) {
+    int middle = (first + last) / 2;
+    if (telemetrySensorsIndex[middle].id < id)
+      first = middle + 1;
+    else
+      last = middle;
+  }
+
+  for (int i=first; i<telemetrySensorsIndexCount && telemetrySensorsIndex[i].id == id; i++) {
+    uint8_t index = telemetrySensorsIndex[i].index;
+    TelemetrySensor & telemetrySensor = g_model.telemetrySensors[index];
+    // the sensor is checked again, the index may be late when a sensor was just edited
+    if (telemetrySensor.type == TELEM_TYPE_CUSTOM && telemetrySensor.id == id && (telemetrySensor.instance == instance || g_model.ignoreSensorIds)) {
+      telemetryItems[index].setValue(telemetrySensor, value, unit, prec);
+      available = true;
+      // we continue search here, because more than one sensor can have the same id and instance
+    }
+  }
+
+  return available;
+}
+
 void setTelemetryValue(TelemetryProtocol protocol, uint16_t id, uint8_t instance, int32_t value, uint32_t unit, uint32_t prec)
 {
+  if (setIndexedTelemetryValue(id, instance, value, unit, prec)) {
+    return;
+  }
+
+  // not in the index, the whole table is scanned before a new sensor is created
   bool available = false;
 
   for (int index=0; index<MAX_SENSORS; index++) {
@@ -491,11 +733,11 @@ void setTelemetryValue(TelemetryProtocol protocol, uint16_t id, uint8_t instance
     if (telemetrySensor.type == TELEM_TYPE_CUSTOM && telemetrySensor.id == id && (telemetrySensor.instance == instance || g_model.ignoreSensorIds)) {
       telemetryItems[index].setValue(telemetrySensor, value, unit, prec);
       available = true;
-      // we continue search here, because more than one sensor can have the same id and instance
     }
   }
 
   if (available) {
+    telemetrySensorsIndexDirty = true;
     return;
   }
   
@@ -516,6 +758,7 @@ void setTelemetryValue(TelemetryProtocol protocol, uint16_t id, uint8_t instance
         return;
     }
     telemetryItems[index].setValue(g_model.telemetrySensors[index], value, unit, prec);
+    telemetrySensorsIndexDirty = true;
   }
   else {
     POPUP_WARNING(STR_TELEMETRYFULL);
@@ -161,6 +161,7 @@ class TelemetryItem
     bool isAvailable();
     bool isFresh();
     bool isOld();
+    void setOld();
     void gpsReceived();
 };
 
@@ -187,6 +188,9 @@ void delTelemetryIndex(uint8_t index);
 int availableTelemetryIndex();
 int lastUsedTelemetryIndex();
 int32_t getTelemetryValue(uint8_t index, uint8_t & prec);
+uint32_t getTelemetrySensorInputs(const TelemetrySensor & sensor);
+bool isTelemetrySensorReading(uint8_t index, uint8_t source);
+void evalCalculatedTelemetrySensors();
 int32_t convertTelemetryValue(int32_t value, uint8_t unit, uint8_t prec, uint8_t destUnit, uint8_t destPrec);
 
 void frskySportSetDefault(int index, uint16_t type, uint8_t instance);
@@ -270,5 +270,6 @@ void applyTemplate(uint8_t idx)
 
     }
 
+    INVALIDATE_MIXER_PROGRAM();
     eeDirty(EE_MODEL);
 }
@@ -0,0 +1,103 @@
+/*
+ * Authors (alphabetical order)
+ * - Andre Bernet <bernet.andre@gmail.com>
+ * - Andreas Weitl
+ * - Bertrand Songis <bsongis@gmail.com>
+ * - Bryan J. Rentoul (Gruvin) <gruvin@gmail.com>
+ * - Cameron Weeks <th9xer@gmail.com>
+ * - Erez Raviv
+ * - Gabriel Birkus
+ * - Jean-Pierre Parisy
+ * - Karl Szmutny
+ * - Michael Blandford
+ * - Michal Hlavinka
+ * - Pat Mackenzie
+ * - Philip Moss
+ * - Rob Thomson
+ * - Romolo Manfredini <romolo.manfredini@gmail.com>
+ * - Thomas Husterer
+ *
+ * opentx is based on code named
+ * gruvin9x by Bryan J. Rentoul: http://code.google.com/p/gruvin9x/,
+ * er9x by Erez Raviv: http://code.google.com/p/er9x/,
+ * and the original (and ongoing) project by
+ * Thomas Husterer, th9x: http://code.google.com/p/th9x/
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ */
+
+#include "gtests.h"
+
+#if defined(PCBTARANIS)
+extern uint16_t Analog_values[NUMBER_ANALOG];
+extern uint16_t adcIirInitialized;
+
+#define ADC_TEST_CHANNELS 2
+
+static void fillScans(uint16_t scans[ADC_SCANS_PER_HALF][ADC_TEST_CHANNELS], uint16_t value0, uint16_t value1)
+{
+  for (int i=0; i<ADC_SCANS_PER_HALF; i++) {
+    scans[i][0] = value0;
+    scans[i][1] = value1;
+  }
+}
+
+TEST(Adc, FilterAverage)
+{
+  uint16_t scans[ADC_SCANS_PER_HALF][ADC_TEST_CHANNELS];
+  adcFilterMode = ADC_FILTER_AVERAGE;
+  for (int i=0; i<ADC_SCANS_PER_HALF; i++) {
+    scans[i][0] = 1000 + (i & 1 ? 8 : -8);
+    scans[i][1] = 3000 + i;
+  }
+  adcFilterScans(scans[0], ADC_SCANS_PER_HALF, 0, ADC_TEST_CHANNELS);
+  EXPECT_EQ(Analog_values[0], 1000);
+  EXPECT_EQ(Analog_values[1], 3000 + (ADC_SCANS_PER_HALF-1)/2);
+  adcFilterMode = ADC_FILTER_IIR;
+}
+
+TEST(Adc, FilterMedian)
+{
+  uint16_t scans[ADC_SCANS_PER_HALF][ADC_TEST_CHANNELS];
+  adcFilterMode = ADC_FILTER_MEDIAN;
+  fillScans(scans, 1000, 2000);
+  // a spike on each channel is rejected
+  static_assert(ADC_SCANS_PER_HALF > 2, "the spikes are in the half buffer");
+  scans[2][0] = 4095;
+  scans[1][1] = 0;
+  adcFilterScans(scans[0], ADC_SCANS_PER_HALF, 0, ADC_TEST_CHANNELS);
+  EXPECT_EQ(Analog_values[0], 1000);
+  EXPECT_EQ(Analog_values[1], 2000);
+  adcFilterMode = ADC_FILTER_IIR;
+}
+
+TEST(Adc, FilterIIR)
+{
+  uint16_t scans[ADC_SCANS_PER_HALF][ADC_TEST_CHANNELS];
+  adcFilterMode = ADC_FILTER_IIR;
+  adcIirInitialized = 0;
+  fillScans(scans, 1000, 0);
+  adcFilterScans(scans[0], ADC_SCANS_PER_HALF, 0, ADC_TEST_CHANNELS);
+  EXPECT_EQ(Analog_values[0], 1000);
+  EXPECT_EQ(Analog_values[1], 0);
+  // a step is followed within a few half buffers, also from 0
+  fillScans(scans, 2000, 1000);
+  adcFilterScans(scans[0], ADC_SCANS_PER_HALF, 0, ADC_TEST_CHANNELS);
+  EXPECT_NEAR(Analog_values[0], 1683, 2);
+  EXPECT_NEAR(Analog_values[1], 683, 2);
+  for (int i=0; i<7; i++) {
+    adcFilterScans(scans[0], ADC_SCANS_PER_HALF, 0, ADC_TEST_CHANNELS);
+  }
+  EXPECT_NEAR(Analog_values[0], 2000, 1);
+  EXPECT_NEAR(Analog_values[1], 1000, 1);
+  adcFilterMode = ADC_FILTER_IIR;
+}
+#endif
@@ -455,4 +455,110 @@ TEST(FrSkySPORT, frskyCurrent)
   EXPECT_EQ(telemetryItems[0].valueMax, 505);
 }
 
+TEST(FrSkySPORT, sensorsCatalogue)
+{
+  const FrSkySportSensor * previous = NULL;
+  for (const FrSkySportSensor * sensor = sportSensors; sensor->firstId; sensor++) {
+    EXPECT_LE(sensor->firstId, sensor->lastId);
+    if (previous) {
+      EXPECT_GT(sensor->firstId, previous->lastId);
+    }
+    previous = sensor;
+  }
+
+  for (uint32_t id=0; id<=0xFFFF; id++) {
+    const FrSkySportSensor * result = NULL;
+    for (const FrSkySportSensor * sensor = sportSensors; sensor->firstId; sensor++) {
+      if (id >= sensor->firstId && id <= sensor->lastId) {
+        result = sensor;
+        break;
+      }
+    }
+    EXPECT_EQ(getFrSkySportSensor(id), result);
+  }
+}
+
+TEST(FrSkySPORT, sensorsIndex)
+{
+  MODEL_RESET();
+  TELEMETRY_RESET();
+
+  setTelemetryValue(TELEM_PROTO_FRSKY_SPORT, VFAS_FIRST_ID, 1, 1200, UNIT_VOLTS, 2);
+  setTelemetryValue(TELEM_PROTO_FRSKY_SPORT, VFAS_FIRST_ID, 2, 1100, UNIT_VOLTS, 2);
+  setTelemetryValue(TELEM_PROTO_FRSKY_SPORT, CURR_FIRST_ID, 1, 50, UNIT_AMPS, 1);
+  EXPECT_EQ(lastUsedTelemetryIndex(), 2);
+  EXPECT_EQ(telemetryItems[0].value, 1200);
+  EXPECT_EQ(telemetryItems[1].value, 1100);
+  EXPECT_EQ(telemetryItems[2].value, 50);
+
+  setTelemetryValue(TELEM_PROTO_FRSKY_SPORT, VFAS_FIRST_ID, 2, 1050, UNIT_VOLTS, 2);
+  EXPECT_EQ(telemetryItems[0].value, 1200);
+  EXPECT_EQ(telemetryItems[1].value, 1050);
+
+  // the sensor is edited without invalidating the index, the value still reaches it
+  g_model.telemetrySensors[2].id = RPM_FIRST_ID;
+  setTelemetryValue(TELEM_PROTO_FRSKY_SPORT, RPM_FIRST_ID, 1, 3000, UNIT_RPMS, 0);
+  EXPECT_EQ(lastUsedTelemetryIndex(), 2);
+  EXPECT_EQ(telemetryItems[2].value, 3000);
+  setTelemetryValue(TELEM_PROTO_FRSKY_SPORT, RPM_FIRST_ID, 1, 3100, UNIT_RPMS, 0);
+  EXPECT_EQ(telemetryItems[2].value, 3100);
+}
+
+TEST(FrSkySPORT, calculatedSensorsOrder)
+{
+  MODEL_RESET();
+  TELEMETRY_RESET();
+
+  setTelemetryValue(TELEM_PROTO_FRSKY_SPORT, VFAS_FIRST_ID, 1, 1200, UNIT_VOLTS, 2);
+
+  // sensor 2 reads sensor 3 which reads sensor 1
+  for (int i=1; i<=2; i++) {
+    g_model.telemetrySensors[i].type = TELEM_TYPE_CALCULATED;
+    g_model.telemetrySensors[i].formula = TELEM_FORMULA_ADD;
+    g_model.telemetrySensors[i].unit = UNIT_VOLTS;
+    g_model.telemetrySensors[i].prec = 2;
+  }
+  g_model.telemetrySensors[1].calc.sources[0] = 3;
+  g_model.telemetrySensors[2].calc.sources[0] = 1;
+  INVALIDATE_MIXER_PROGRAM();
+
+  EXPECT_TRUE(isTelemetrySensorReading(1, 0));
+  EXPECT_TRUE(isTelemetrySensorReading(1, 2));
+  EXPECT_TRUE(isTelemetrySensorReading(1, 1));
+  EXPECT_FALSE(isTelemetrySensorReading(2, 1));
+  EXPECT_FALSE(isTelemetrySensorReading(0, 2));
+
+  evalCalculatedTelemetrySensors();
+  EXPECT_EQ(telemetryItems[2].value, 1200);
+  EXPECT_EQ(telemetryItems[1].value, 1200);
+
+  // the values of the same cycle
+  setTelemetryValue(TELEM_PROTO_FRSKY_SPORT, VFAS_FIRST_ID, 1, 1100, UNIT_VOLTS, 2);
+  evalCalculatedTelemetrySensors();
+  EXPECT_EQ(telemetryItems[2].value, 1100);
+  EXPECT_EQ(telemetryItems[1].value, 1100);
+
+  // no new value, nothing evaluated
+  telemetryItems[1].value = 0;
+  evalCalculatedTelemetrySensors();
+  EXPECT_EQ(telemetryItems[1].value, 0);
+
+  // the input gets old
+  telemetryItems[0].setOld();
+  evalCalculatedTelemetrySensors();
+  EXPECT_TRUE(telemetryItems[2].isOld());
+  EXPECT_TRUE(telemetryItems[1].isOld());
+
+  // a loop, which the menus don't allow, is evaluated in slot order
+  TELEMETRY_RESET();
+  setTelemetryValue(TELEM_PROTO_FRSKY_SPORT, VFAS_FIRST_ID, 1, 1000, UNIT_VOLTS, 2);
+  evalCalculatedTelemetrySensors();
+  g_model.telemetrySensors[2].calc.sources[1] = 2;
+  INVALIDATE_MIXER_PROGRAM();
+  EXPECT_TRUE(isTelemetrySensorReading(2, 1));
+  evalCalculatedTelemetrySensors();
+  EXPECT_EQ(telemetryItems[1].value, 1000);
+  EXPECT_EQ(telemetryItems[2].value, 2000);
+}
+
 #endif  //#if defined(FRSKY_SPORT)
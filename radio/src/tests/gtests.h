@@ -29,6 +29,7 @@ inline void MODEL_RESET()
   extern uint8_t s_mixer_first_run_done;
   s_mixer_first_run_done = false;
   lastFlightMode = 255;
+  INVALIDATE_MIXER_PROGRAM();
 }
 
 inline void MIXER_RESET()
@@ -407,6 +407,74 @@ TEST(Lcd, lcd_bmpLoadAndDisplay)
     bitmap.leakCheck();
   }
 }
+
+TEST(Lcd, bmpCache)
+{
+  bmpCacheReset();
+
+  uint8_t bitmap[BITMAP_BUFFER_SIZE(31, 31)];
+  EXPECT_EQ(bmpLoad(bitmap, "./tests/4b_31x31.bmp", 31, 31), (char *)0);
+  uint16_t id = bmpCacheLoad("./tests/4b_31x31.bmp", 31, 31);
+  ASSERT_NE(id, 0);
+  EXPECT_EQ(memcmp(bmpCacheGet(id), bitmap, sizeof(bitmap)), 0);
+  EXPECT_EQ(bmpCacheLoad("./tests/4b_31x31.bmp", LCD_W/2, LCD_H), id) << "not decoded again";
+  EXPECT_EQ(bmpCacheLoad("./tests/4b_31x31.bmp", 30, 31), 0) << "to small buffer";
+  EXPECT_EQ(bmpCacheLoad("./tests/none.bmp", 31, 31), 0);
+
+  // the same file under different paths fills all the entries
+  char paths[BITMAP_CACHE_ENTRIES+1][64];
+  uint16_t ids[BITMAP_CACHE_ENTRIES+1];
+  for (int i=0; i<=BITMAP_CACHE_ENTRIES; i++) {
+    strcpy(paths[i], "./tests/");
+    for (int j=0; j<i; j++) strcat(paths[i], "./");
+    strcat(paths[i], "4b_7x32.bmp");
+  }
+  for (int i=0; i<BITMAP_CACHE_ENTRIES; i++) {
+    ids[i] = bmpCacheLoad(paths[i], LCD_W/2, LCD_H);
+    ASSERT_NE(ids[i], 0);
+  }
+  EXPECT_TRUE(bmpCacheHold(ids[0]));
+  EXPECT_EQ(bmpCacheLoad(paths[1], 7, 32), ids[1]);
+
+  // the least recently used entry which is not held is evicted
+  ids[BITMAP_CACHE_ENTRIES] = bmpCacheLoad(paths[BITMAP_CACHE_ENTRIES], LCD_W/2, LCD_H);
+  EXPECT_NE(ids[BITMAP_CACHE_ENTRIES], 0);
+  EXPECT_TRUE(bmpCacheGet(ids[0]) != NULL);
+  EXPECT_TRUE(bmpCacheGet(ids[1]) != NULL);
+  EXPECT_TRUE(bmpCacheGet(ids[2]) == NULL);
+  EXPECT_EQ(bmpCacheLoad(paths[0], 7, 32), ids[0]);
+
+  // the entries moved by the compaction keep their content
+  EXPECT_EQ(bmpLoad(bitmap, "./tests/4b_7x32.bmp", 7, 32), (char *)0);
+  for (int i=0; i<=BITMAP_CACHE_ENTRIES; i++) {
+    const uint8_t * bmp = bmpCacheGet(ids[i]);
+    if (bmp) {
+      EXPECT_EQ(memcmp(bmp, bitmap, BITMAP_BUFFER_SIZE(7, 32)), 0);
+    }
+  }
+
+  EXPECT_TRUE(bmpCacheHold(ids[1]));
+  bmpCacheReleaseAll();
+  for (int i=0; i<=BITMAP_CACHE_ENTRIES; i++) {
+    EXPECT_NE(bmpCacheLoad(paths[i], LCD_W/2, LCD_H), 0);
+  }
+  EXPECT_TRUE(bmpCacheGet(ids[0]) == NULL) << "evicted once released";
+
+  // a bitmap too big for the cache is not cached and keeps the other entries
+  bmpCacheReset();
+  uint16_t small = bmpCacheLoad("./tests/4b_7x32.bmp", LCD_W/2, LCD_H);
+  id = bmpCacheLoad("./tests/4b_31x31.bmp", LCD_W/2, LCD_H);
+  ASSERT_GT(BITMAP_BUFFER_SIZE(94, 48), BITMAP_CACHE_SIZE);
+  EXPECT_EQ(bmpCacheLoad("./tests/4b_94x48.bmp", LCD_W/2, LCD_H), 0);
+  EXPECT_TRUE(bmpCacheGet(small) != NULL);
+  EXPECT_TRUE(bmpCacheGet(id) != NULL);
+
+  // the held entries leave room for the model bitmap
+  id = bmpCacheLoad("./tests/plane.bmp", LCD_W/2, LCD_H);
+  EXPECT_TRUE(bmpCacheHold(id));
+  EXPECT_FALSE(bmpCacheHold(bmpCacheLoad("./tests/4b_31x31.bmp", LCD_W/2, LCD_H)));
+  bmpCacheReleaseAll();
+}
 #endif
 
 #if defined(PCBTARANIS)
@@ -475,3 +543,152 @@ TEST(Lcd, lcd_line)
   EXPECT_TRUE(checkScreenshot("lcd_line"));
 }
 #endif
+
+#if defined(PCBTARANIS)
+TEST(Lcd, lcdGetChangedPages)
+{
+  lcd_clear();
+  lcdInvalidatePages();
+  EXPECT_EQ(LCD_ALL_PAGES, lcdGetChangedPages());
+
+  // nothing drawn, or the same frame drawn again
+  EXPECT_EQ(0u, lcdGetChangedPages());
+  lcd_clear();
+  EXPECT_EQ(0u, lcdGetChangedPages());
+
+  lcd_plot(10, 5, 0);
+  EXPECT_EQ(1u << 2, lcdGetChangedPages());
+
+  lcd_hline(0, LCD_H-1, 20);
+  EXPECT_EQ(1u << 31, lcdGetChangedPages());
+
+  lcd_putsAtt(0, 2*FH, "X", 0);
+  uint32_t pages = lcdGetChangedPages();
+  EXPECT_NE(0u, pages);
+  EXPECT_EQ(0u, pages & ~0x00000F00u);
+
+  lcd_invert_line(1);
+  EXPECT_EQ(0x000000F0u, lcdGetChangedPages());
+
+  // the same pixel is erased, the page goes back to the displayed content
+  lcd_plot(10, 5, 0);
+  lcd_plot(10, 5, 0);
+  EXPECT_EQ(0u, lcdGetChangedPages());
+}
+#endif
+
+#if defined(PCBTARANIS)
+// the same primitives, one pixel at a time
+static void plotHlineStip(coord_t x, coord_t y, coord_t w, uint8_t pat, LcdFlags att)
+{
+  for (coord_t i=0; i<w && x+i<LCD_W; i++) {
+    if (pat & 1) lcd_plot(x+i, y, att);
+    pat = (pat >> 1) | (pat << 7);
+  }
+}
+
+static void plotVlineStip(coord_t x, coord_t y, coord_t h, uint8_t pat, LcdFlags att)
+{
+  if (y+h > LCD_H) h = LCD_H - y;
+  if (pat==DOTTED && !(y%2)) pat = ~pat;
+  while (h--) {
+    if (pat & 1) lcd_plot(x, y, att);
+    pat = (pat >> 1) | (pat << 7);
+    y++;
+  }
+}
+
+static void plotFilledRect(coord_t x, coord_t y, coord_t w, coord_t h, uint8_t pat, LcdFlags att)
+{
+  for (coord_t i=y; i<y+h; i++) {
+    if ((att&ROUND) && (i==y || i==y+h-1))
+      plotHlineStip(x+1, i, w-2, pat, att);
+    else
+      plotHlineStip(x, i, w, pat, att);
+    pat = (pat >> 1) + ((pat & 1) << 7);
+  }
+}
+
+TEST(Lcd, spansMatchPixels)
+{
+  const LcdFlags flags[] = { 0, FORCE, ERASE, FILL_WHITE, FORCE|FILL_WHITE, ROUND, FORCE|ROUND|GREY(11), ERASE|GREY(5), GREY(3) };
+  const uint8_t patterns[] = { SOLID, DOTTED, 0x33, 0x01, 0xFE };
+  display_t background[DISPLAY_BUF_SIZE];
+  display_t expected[DISPLAY_BUF_SIZE];
+
+  srand(1);
+  for (int n=0; n<3000; n++) {
+    for (unsigned int i=0; i<DISPLAY_BUF_SIZE; i++) {
+      background[i] = (i % 3) ? rand() : 0;
+    }
+    coord_t x = rand() % LCD_W;
+    coord_t y = rand() % LCD_H;
+    coord_t w = 1 + rand() % LCD_W;
+    coord_t h = 1 + rand() % LCD_H;
+    uint8_t pat = patterns[rand() % DIM(patterns)];
+    LcdFlags att = flags[rand() % DIM(flags)];
+
+    for (int pass=0; pass<2; pass++) {
+      memcpy(displayBuf, background, DISPLAY_BUFER_SIZE);
+      switch (n % 3) {
+        case 0:
+          if (pass) lcd_hlineStip(x, y, w, pat, att); else plotHlineStip(x, y, w, pat, att);
+          break;
+        case 1:
+          if (pass) lcd_vlineStip(x, y, h, pat, att); else plotVlineStip(x, y, h, pat, att);
+          break;
+        case 2:
+          if (pass) drawFilledRect(x, y, w, h, pat, att); else plotFilledRect(x, y, w, h, pat, att);
+          break;
+      }
+      if (!pass) memcpy(expected, displayBuf, DISPLAY_BUFER_SIZE);
+    }
+    ASSERT_EQ(0, memcmp(expected, displayBuf, DISPLAY_BUFER_SIZE)) << "test " << n << " x=" << x << " y=" << y << " w=" << w << " h=" << h << " pat=" << (int)pat << " att=" << att;
+  }
+}
+#endif
+
+#if defined(PCBTARANIS)
+TEST(Lcd, glyphCacheMatchesPixels)
+{
+  const LcdFlags flags[] = { 0, INVERS, FIXEDWIDTH, CONDENSED, SMLSIZE, SMLSIZE|INVERS, TINSIZE, MIDSIZE, MIDSIZE|INVERS, BOLD, BOLD|INVERS, DBLSIZE };
+  const char * strings[] = { "0123456789", "Alt -12.5m", "RSSI", "|_,:;", "\300\301" };
+  display_t background[DISPLAY_BUF_SIZE];
+  display_t expected[DISPLAY_BUF_SIZE];
+
+  glyphCacheReset();
+  srand(2);
+  for (int n=0; n<2000; n++) {
+    for (unsigned int i=0; i<DISPLAY_BUF_SIZE; i++) {
+      background[i] = (i % 3) ? rand() : 0;
+    }
+    coord_t x = (n % 7 == 0) ? 0 : rand() % LCD_W;
+    coord_t y = (n % 5 == 0) ? 0 : rand() % LCD_H;
+    LcdFlags att = flags[rand() % DIM(flags)];
+    const char * s = strings[rand() % DIM(strings)];
+    coord_t nextPos = 0;
+
+    for (int pass=0; pass<2; pass++) {
+      glyphCacheEnabled = pass;
+      memcpy(displayBuf, background, DISPLAY_BUFER_SIZE);
+      lcd_putsAtt(x, y, s, att);
+      if (!pass) {
+        memcpy(expected, displayBuf, DISPLAY_BUFER_SIZE);
+        nextPos = lcdNextPos;
+      }
+    }
+    ASSERT_EQ(0, memcmp(expected, displayBuf, DISPLAY_BUFER_SIZE)) << "test " << n << " x=" << x << " y=" << y << " att=" << att << " " << s;
+    ASSERT_EQ(nextPos, lcdNextPos);
+  }
+
+  EXPECT_LE(glyphCacheStats.used, GLYPH_CACHE_SIZE);
+
+  // the same text drawn again somewhere else comes from the cache (2 glyphs always fit in a set)
+  glyphCacheReset();
+  lcd_putsAtt(10, 10, "01", 0);
+  EXPECT_EQ(2u, glyphCacheStats.misses);
+  lcd_putsAtt(60, 30, "01", 0);
+  EXPECT_EQ(2u, glyphCacheStats.hits);
+  EXPECT_EQ(2, glyphCacheStats.used);
+}
+#endif
@@ -187,4 +187,29 @@ TEST(Lua, testModelInputs)
 
 }
 
+TEST(Lua, testLoadPixmap)
+{
+  bmpCacheReset();
+  luaExecStr("icon = lcd.loadPixmap('./tests/4b_7x32.bmp')");
+  luaExecStr("if icon == nil then error('loadPixmap()') end");
+  luaExecStr("if lcd.loadPixmap('./tests/none.bmp') ~= nil then error('loadPixmap() of a missing file') end");
+  luaExecStr("lcd.releasePixmap(icon)");
+}
+
+#if defined(GVARS)
+TEST(Lua, testSetGlobalVariable)
+{
+  MODEL_RESET();
+  g_model.flightModeData[0].gvars[0] = 20;
+  g_model.flightModeData[1].gvars[0] = GVAR_MAX+1; // FM0 value
+  INVALIDATE_MIXER_PROGRAM();
+  checkFlightModesInheritance();
+  EXPECT_EQ(GVAR_VALUE(0, getGVarFlightPhase(1, 0)), 20);
+
+  luaExecStr("model.setGlobalVariable(0, 1, 7)");
+  checkFlightModesInheritance(); // as the mixer does
+  EXPECT_EQ(GVAR_VALUE(0, getGVarFlightPhase(1, 0)), 7);
+}
+#endif
+
 #endif   // #if defined(LUA)
@@ -35,6 +35,7 @@
  */
 
 #include "gtests.h"
+#include "timers.h"
 
 #define CHECK_NO_MOVEMENT(channel, value, duration) \
     for (int i=1; i<=(duration); i++) { \
@@ -345,6 +346,9 @@ TEST(Trims, greaterTrimLink)
   MODEL_RESET();
   setTrimValue(1, RUD_STICK, TRIM_EXTENDED_MAX+3); // link to FP3 trim
   setTrimValue(3, RUD_STICK, 32);
+#if defined(CPUARM)
+  checkFlightModesInheritance();
+#endif
   EXPECT_EQ(getRawTrimValue(getTrimFlightPhase(1, RUD_STICK), RUD_STICK), 32);
 }
 
@@ -354,6 +358,9 @@ TEST(Trims, chainedTrims)
   setTrimValue(0, RUD_STICK, 32);
   setTrimValue(1, RUD_STICK, TRIM_EXTENDED_MAX+1); // link to FP0 trim
   setTrimValue(2, RUD_STICK, TRIM_EXTENDED_MAX+2); // link to FP1 trim
+#if defined(CPUARM)
+  checkFlightModesInheritance();
+#endif
   EXPECT_EQ(getRawTrimValue(getTrimFlightPhase(0, RUD_STICK), RUD_STICK), 32);
 }
 
@@ -364,10 +371,76 @@ TEST(Trims, infiniteChainedTrims)
   setTrimValue(1, RUD_STICK, TRIM_EXTENDED_MAX+3); // link to FP3 trim
   setTrimValue(2, RUD_STICK, TRIM_EXTENDED_MAX+2); // link to FP1 trim
   setTrimValue(3, RUD_STICK, TRIM_EXTENDED_MAX+3); // link to FP2 trim
+#if defined(CPUARM)
+  checkFlightModesInheritance();
+#endif
   EXPECT_EQ(getRawTrimValue(getTrimFlightPhase(0, RUD_STICK), RUD_STICK), 32);
 }
 #endif
 
+#if defined(PCBTARANIS)
+TEST(Trims, addedTrimsChain)
+{
+  MODEL_RESET();
+  g_model.flightModeData[0].trim[RUD_STICK].value = 32;
+  g_model.flightModeData[1].trim[RUD_STICK].mode = (0 << 1) + 1; // FM0 trim added
+  g_model.flightModeData[1].trim[RUD_STICK].value = 10;
+  g_model.flightModeData[2].trim[RUD_STICK].mode = (1 << 1); // FM1 trim
+  g_model.flightModeData[3].trim[RUD_STICK].mode = TRIM_MODE_NONE;
+  INVALIDATE_MIXER_PROGRAM();
+  checkFlightModesInheritance(); // as the mixer does, or the editors with the mixer paused
+  EXPECT_EQ(getTrimValue(0, RUD_STICK), 32);
+  EXPECT_EQ(getTrimValue(1, RUD_STICK), 42);
+  EXPECT_EQ(getTrimValue(2, RUD_STICK), 42);
+  EXPECT_EQ(getTrimValue(3, RUD_STICK), 0);
+
+  // the values are not part of the resolution
+  g_model.flightModeData[0].trim[RUD_STICK].value = 30;
+  EXPECT_EQ(getTrimValue(2, RUD_STICK), 40);
+
+  // a change of flight mode trim is taken into account once the model is invalidated
+  g_model.flightModeData[2].trim[RUD_STICK].mode = (2 << 1);
+  g_model.flightModeData[2].trim[RUD_STICK].value = 5;
+  INVALIDATE_MIXER_PROGRAM();
+  checkFlightModesInheritance();
+  EXPECT_EQ(getTrimValue(2, RUD_STICK), 5);
+
+  // loops don't have any trim
+  g_model.flightModeData[1].trim[RUD_STICK].mode = (2 << 1) + 1;
+  g_model.flightModeData[2].trim[RUD_STICK].mode = (1 << 1) + 1;
+  INVALIDATE_MIXER_PROGRAM();
+  checkFlightModesInheritance();
+  EXPECT_EQ(getTrimValue(1, RUD_STICK), 0);
+  EXPECT_EQ(getTrimValue(2, RUD_STICK), 0);
+}
+#endif
+
+#if defined(CPUARM) && defined(GVARS)
+TEST(Gvars, flightModesInheritance)
+{
+  MODEL_RESET();
+  MIXER_RESET();
+  g_model.flightModeData[0].gvars[0] = 20;
+  g_model.flightModeData[1].gvars[0] = GVAR_MAX+1; // FM0 value
+  g_model.flightModeData[2].gvars[0] = GVAR_MAX+2; // FM1 value
+  INVALIDATE_MIXER_PROGRAM();
+  checkFlightModesInheritance();
+  EXPECT_EQ(getGVarFlightPhase(2, 0), 0);
+  mixerCurrentFlightMode = 2;
+  EXPECT_EQ(getValue(MIXSRC_GVAR1), 20);
+
+  g_model.flightModeData[1].gvars[0] = 7;
+  INVALIDATE_MIXER_PROGRAM();
+  checkFlightModesInheritance();
+  EXPECT_EQ(getGVarFlightPhase(2, 0), 1);
+  EXPECT_EQ(getValue(MIXSRC_GVAR1), 7);
+
+  setGVarValue(0, 8, 2);
+  EXPECT_EQ(g_model.flightModeData[1].gvars[0], 8);
+  mixerCurrentFlightMode = 0;
+}
+#endif
+
 TEST(Trims, CopyTrimsToOffset)
 {
   MODEL_RESET();
@@ -440,6 +513,53 @@ TEST(Curves, LinearIntpol)
   EXPECT_EQ(applyCustomCurve(-192, 0), -192);
 }
 
+#if defined(XCURVES)
+TEST(Curves, TablesMatchComputation)
+{
+  const int8_t custom[] = { -100, -80, 30, 100, 90, -60, -5, 40 };
+  for (int type=CURVE_TYPE_STANDARD; type<=CURVE_TYPE_CUSTOM; type++) {
+    for (int smooth=0; smooth<=1; smooth++) {
+      for (int count=2; count<=MAX_POINTS; count+=3) {
+        MODEL_RESET();
+        g_model.curves[0].type = type;
+        g_model.curves[0].smooth = smooth;
+        g_model.curves[0].points = count - 5;
+        for (int i=0; i<count; i++) {
+          g_model.points[i] = ((i * 73) % 201) - 100;
+          if (type == CURVE_TYPE_CUSTOM && i > 0 && i < count-1)
+            g_model.points[count+i-1] = -100 + (i*200)/(count-1) + custom[i%8]/20;
+        }
+        loadCurves();
+        for (int x=-RESX-100; x<=RESX+100; x++) {
+          ASSERT_EQ(applyCustomCurve(x, 0), computeCustomCurve(x, 0)) << "type=" << type << " smooth=" << smooth << " count=" << count << " x=" << x;
+        }
+        // the table must follow a curve edited after the model has been loaded
+        g_model.points[count/2] = -g_model.points[count/2] / 2;
+        invalidateCurveTable(0);
+        for (int x=-RESX; x<=RESX; x+=7) {
+          ASSERT_EQ(applyCustomCurve(x, 0), computeCustomCurve(x, 0)) << "type=" << type << " smooth=" << smooth << " count=" << count << " x=" << x;
+        }
+      }
+    }
+  }
+}
+#endif
+
+#if defined(CPUARM)
+TEST(Curves, ExpoTablesMatchComputation)
+{
+  for (int k=-100; k<=100; k+=5) {
+    for (int x=-RESX-100; x<=RESX+100; x++) {
+      // the tables points are exact, the interpolated values may be 1 step away
+      if (x % 4 == 0 || x < -RESX || x > RESX)
+        ASSERT_EQ(expo(x, k), computeExpo(x, k)) << "k=" << k << " x=" << x;
+      else
+        ASSERT_NEAR(expo(x, k), computeExpo(x, k), 1) << "k=" << k << " x=" << x;
+    }
+  }
+}
+#endif
+
 
 #if !defined(CPUARM)
 TEST(FlightModes, nullFadeOut_posFadeIn)
@@ -572,6 +692,152 @@ TEST(Mixer, InfiniteRecursiveChannels)
   EXPECT_EQ(chans[0], 0);
 }
 
+#if defined(CPUARM)
+TEST(Mixer, InfiniteRecursiveChannelsProgram)
+{
+  MODEL_RESET();
+  MIXER_RESET();
+  g_model.mixData[0].destCh = 0;
+  g_model.mixData[0].srcRaw = MIXSRC_CH2;
+  g_model.mixData[0].weight = 100;
+  g_model.mixData[1].destCh = 1;
+  g_model.mixData[1].srcRaw = MIXSRC_CH1;
+  g_model.mixData[1].weight = 100;
+  evalFlightModeMixes(e_perout_mode_normal, 0);
+  EXPECT_EQ(mixerProgram.state, MIXER_PROGRAM_CYCLIC);
+}
+
+TEST(Mixer, Cascaded8ChannelsProgram)
+{
+  MODEL_RESET();
+  MIXER_RESET();
+  for (int i=0; i<7; i++) {
+    g_model.mixData[i].destCh = i;
+    g_model.mixData[i].srcRaw = MIXSRC_CH2+i;
+    g_model.mixData[i].weight = 100;
+  }
+  g_model.mixData[7].destCh = 7;
+  g_model.mixData[7].srcRaw = MIXSRC_MAX;
+  g_model.mixData[7].weight = 100;
+  evalFlightModeMixes(e_perout_mode_normal, 0);
+  EXPECT_EQ(mixerProgram.state, MIXER_PROGRAM_READY);
+  EXPECT_EQ(mixerProgram.count, 8);
+  EXPECT_EQ(mixerProgram.lines[0], 7);
+  for (int i=0; i<8; i++) {
+    EXPECT_EQ(chans[i], CHANNEL_MAX);
+  }
+}
+
+TEST(Mixer, FlightModesFadeSharedChannels)
+{
+  MODEL_RESET();
+  MIXER_RESET();
+  g_model.flightModeData[1].fadeIn = 1;
+  g_model.mixData[0].destCh = 0;
+  g_model.mixData[0].srcRaw = MIXSRC_MAX;
+  g_model.mixData[0].weight = 100;
+  g_model.mixData[1].destCh = 1;
+  g_model.mixData[1].srcRaw = MIXSRC_MAX;
+  g_model.mixData[1].weight = 100;
+  g_model.mixData[1].flightModes = 0x1FE; // only enabled in flight mode 0
+  g_model.mixData[2].destCh = 2;
+  g_model.mixData[2].srcRaw = MIXSRC_CH2;
+  g_model.mixData[2].weight = 100;
+  g_model.mixData[3].destCh = 3;
+  g_model.mixData[3].srcRaw = MIXSRC_CH1;
+  g_model.mixData[3].weight = 100;
+  lastFlightMode = 255;
+  evalMixes(1);
+  EXPECT_EQ(mixerProgram.state, MIXER_PROGRAM_READY);
+  EXPECT_EQ(mixerProgram.fmDependentChannels, (bitfield_channels_t)0x06);
+  EXPECT_EQ(channelOutputs[1], 1024);
+
+  g_model.flightModeData[1].swtch = SWSRC_ON;
+  bool fading = false;
+  for (int i=0; i<20; i++) {
+    evalMixes(1);
+    EXPECT_EQ(mixerCurrentFlightMode, 1);
+    EXPECT_EQ(channelOutputs[0], 1024);
+    EXPECT_EQ(channelOutputs[2], channelOutputs[1]);
+    EXPECT_EQ(channelOutputs[3], 1024);
+    if (channelOutputs[1] > 0 && channelOutputs[1] < 1024) fading = true;
+  }
+  EXPECT_TRUE(fading);
+  EXPECT_EQ(channelOutputs[1], 0);
+  EXPECT_EQ(channelOutputs[2], 0);
+}
+#endif
+
+#if defined(CPUARM)
+TEST(Mixer, ChannelOutputsFrames)
+{
+  MODEL_RESET();
+  MIXER_RESET();
+  g_model.mixData[0].destCh = 0;
+  g_model.mixData[0].srcRaw = MIXSRC_MAX;
+  g_model.mixData[0].weight = 100;
+  evalMixes(1);
+  const int16_t * frame = channelOutputs;
+  EXPECT_EQ(frame[0], 1024);
+
+  // the next cycle doesn't write to the published frame
+  g_model.mixData[0].weight = -100;
+  evalMixes(1);
+  EXPECT_EQ(frame[0], 1024);
+  EXPECT_EQ(channelOutputs[0], -1024);
+}
+#endif
+
+#if defined(PCBTARANIS)
+TEST(Mixer, FrameLatency)
+{
+  MODEL_RESET();
+  MIXER_RESET();
+  g_model.moduleData[EXTERNAL_MODULE].type = MODULE_TYPE_PPM;
+  maxFrameLatency = 0;
+
+  TIMER_2MHz_TIMER->CNT = 1000;
+  doMixerCalculations();
+  TIMER_2MHz_TIMER->CNT = 3000;
+  setupPulses(EXTERNAL_MODULE);
+  EXPECT_EQ(lastFrameLatency, 2000);
+
+  // the same frame is latched again if the mixer didn't run meanwhile
+  TIMER_2MHz_TIMER->CNT = 8000;
+  setupPulses(EXTERNAL_MODULE);
+  EXPECT_EQ(lastFrameLatency, 7000);
+
+  TIMER_2MHz_TIMER->CNT = 9000;
+  doMixerCalculations();
+  TIMER_2MHz_TIMER->CNT = 9500;
+  setupPulses(EXTERNAL_MODULE);
+  EXPECT_EQ(lastFrameLatency, 500);
+  EXPECT_EQ(maxFrameLatency, 7000);
+}
+#endif
+
+#if defined(PCBTARANIS) && defined(MIXER_PROFILE)
+TEST(Mixer, Profile)
+{
+  mixerProfileReset();
+  for (int i=1; i<=3; i++) {
+    TIMER_2MHz_TIMER->CNT = 65500;
+    mixerProfileStart();
+    TIMER_2MHz_TIMER->CNT = 65500 + 100*i;
+    mixerProfileStage(MIXER_STAGE_ADC);
+    mixerProfileEnd();
+  }
+  EXPECT_EQ(mixerProfile[MIXER_STAGE_ADC].min, 100);
+  EXPECT_EQ(mixerProfile[MIXER_STAGE_ADC].max, 300);
+  EXPECT_EQ(mixerProfile[MIXER_STAGE_ADC].sum, 600);
+  EXPECT_EQ(mixerProfile[MIXER_STAGE_ADC].count, 3);
+  EXPECT_EQ(mixerProfile[MIXER_STAGE_ADC].histogram[7], 1); // 100
+  EXPECT_EQ(mixerProfile[MIXER_STAGE_ADC].histogram[8], 1); // 200
+  EXPECT_EQ(mixerProfile[MIXER_STAGE_ADC].histogram[9], 1); // 300
+  EXPECT_EQ(mixerProfile[MIXER_STAGE_LIMITS].histogram[0], 3);
+}
+#endif
+
 TEST(Mixer, BlockingChannel)
 {
   MODEL_RESET();
@@ -1023,3 +1289,137 @@ TEST(Trainer, UnpluggedTest)
   ppmInput[0] = 1024;
   CHECK_DELAY(0, 5000);
 }
+
+#if defined(CPUARM)
+TEST(Sources, getValueDispatch)
+{
+  MODEL_RESET();
+  MIXER_RESET();
+  EXPECT_EQ(getValue(MIXSRC_NONE), 0);
+  EXPECT_EQ(getValue(MIXSRC_MAX), 1024);
+  ex_chans[3] = 512;
+  EXPECT_EQ(getValue(MIXSRC_CH1+3), 512);
+  timersStates[1].val = 42;
+  EXPECT_EQ(getValue(MIXSRC_TIMER2), 42);
+  telemetryItems[1].value = 11;
+  telemetryItems[1].valueMax = 33;
+  EXPECT_EQ(getValue(MIXSRC_FIRST_TELEM+3), 11);
+  EXPECT_EQ(getValue(MIXSRC_FIRST_TELEM+5), 33);
+  EXPECT_EQ(getValue(MIXSRC_LAST_TELEM+1), 0);
+#if defined(VIRTUALINPUTS)
+  anas[2] = -100;
+  EXPECT_EQ(getValue(MIXSRC_FIRST_INPUT+2), -100);
+#endif
+  ex_chans[3] = 0;
+  timersStates[1].val = 0;
+  TELEMETRY_RESET();
+}
+
+// the if / else chain of getValue() before the dispatch table, the reference of the table
+static getvalue_t getValueChain(mixsrc_t i)
+{
+  if (i==MIXSRC_NONE) return 0;
+#if defined(VIRTUALINPUTS)
+  else if (i<=MIXSRC_LAST_INPUT) return anas[i-MIXSRC_FIRST_INPUT];
+#endif
+#if defined(LUAINPUTS)
+  // the chain compared with <, its last Lua source fell through to the sticks
+  else if (i<=MIXSRC_LAST_LUA) {
+#if defined(LUA_MODEL_SCRIPTS)
+    div_t qr = div(i-MIXSRC_FIRST_LUA, MAX_SCRIPT_OUTPUTS);
+    return SCRIPT_OUTPUT_VALUE(qr.quot, qr.rem);
+#else
+    return 0;
+#endif
+  }
+#endif
+  else if (i<=MIXSRC_LAST_POT) return calibratedStick[i-MIXSRC_Rud];
+#if defined(ROTARY_ENCODERS)
+  else if (i<=MIXSRC_LAST_ROTARY_ENCODER) return getRotaryEncoder(i-MIXSRC_REa);
+#endif
+  else if (i==MIXSRC_MAX) return 1024;
+  else if (i<=MIXSRC_CYC3)
+#if defined(HELI)
+    return cyc_anas[i-MIXSRC_CYC1];
+#else
+    return 0;
+#endif
+  else if (i<=MIXSRC_TrimAil) return calc1000toRESX((int16_t)8 * getTrimValue(mixerCurrentFlightMode, i-MIXSRC_TrimRud));
+#if defined(PCBTARANIS)
+  else if ((i >= MIXSRC_FIRST_SWITCH) && (i <= MIXSRC_LAST_SWITCH)) {
+    mixsrc_t sw = i-MIXSRC_FIRST_SWITCH;
+    if (SWITCH_EXISTS(sw))
+      return (switchState((EnumKeys)(SW_BASE+(3*sw))) ? -1024 : (switchState((EnumKeys)(SW_BASE+(3*sw)+1)) ? 0 : 1024));
+    else
+      return 0;
+  }
+#else
+  else if (i==MIXSRC_3POS) return (getSwitch(SW_ID0-SW_BASE+1) ? -1024 : (getSwitch(SW_ID1-SW_BASE+1) ? 0 : 1024));
+  else if (i<MIXSRC_SW1) return getSwitch(SWSRC_THR+i-MIXSRC_THR) ? 1024 : -1024;
+#endif
+  else if (i<=MIXSRC_LAST_LOGICAL_SWITCH) return getSwitch(SWSRC_FIRST_LOGICAL_SWITCH+i-MIXSRC_FIRST_LOGICAL_SWITCH) ? 1024 : -1024;
+  else if (i<=MIXSRC_LAST_TRAINER) { int16_t x = ppmInput[i-MIXSRC_FIRST_TRAINER]; if (i<MIXSRC_FIRST_TRAINER+NUM_CAL_PPM) { x-= g_eeGeneral.trainer.calib[i-MIXSRC_FIRST_TRAINER]; } return x*2; }
+  else if (i<=MIXSRC_LAST_CH) return ex_chans[i-MIXSRC_CH1];
+#if defined(GVARS)
+  else if (i<=MIXSRC_LAST_GVAR) return GVAR_VALUE(i-MIXSRC_GVAR1, getGVarFlightPhase(mixerCurrentFlightMode, i-MIXSRC_GVAR1));
+#endif
+  else if (i==MIXSRC_TX_VOLTAGE) return g_vbat100mV;
+  else if (i<MIXSRC_FIRST_TIMER)
+#if defined(RTCLOCK)
+    return (g_rtcTime % SECS_PER_DAY) / 60;
+#else
+    return 0;
+#endif
+  else if (i<=MIXSRC_LAST_TIMER) return timersStates[i-MIXSRC_FIRST_TIMER].val;
+  else if (i<=MIXSRC_LAST_TELEM) {
+    div_t qr = div(i-MIXSRC_FIRST_TELEM, 3);
+    TelemetryItem & telemetryItem = telemetryItems[qr.quot];
+    return (qr.rem == 1 ? telemetryItem.valueMin : (qr.rem == 2 ? telemetryItem.valueMax : telemetryItem.value));
+  }
+  else return 0;
+}
+
+TEST(Sources, getValueMatchesChain)
+{
+  MODEL_RESET();
+  MIXER_RESET();
+  TELEMETRY_RESET();
+  // a different value in each source
+#if defined(VIRTUALINPUTS)
+  for (int i=0; i<MAX_INPUTS; i++) anas[i] = 100+i;
+#endif
+#if defined(LUA_MODEL_SCRIPTS)
+  for (int i=0; i<MAX_SCRIPTS*MAX_SCRIPT_OUTPUTS; i++) SCRIPT_OUTPUT_VALUE(i/MAX_SCRIPT_OUTPUTS, i%MAX_SCRIPT_OUTPUTS) = 900+i;
+#endif
+  for (int i=0; i<NUM_STICKS+NUM_POTS; i++) calibratedStick[i] = 200+i;
+  for (int i=0; i<NUM_STICKS; i++) setTrimValue(0, i, 10+i);
+  for (int i=0; i<NUM_TRAINER; i++) ppmInput[i] = 300+i;
+  for (int i=0; i<NUM_CAL_PPM; i++) g_eeGeneral.trainer.calib[i] = i+1;
+  for (int i=0; i<NUM_CHNOUT; i++) ex_chans[i] = 400+i;
+#if defined(GVARS)
+  for (int i=0; i<MAX_GVARS; i++) g_model.flightModeData[0].gvars[i] = 50+i;
+#endif
+  g_vbat100mV = 77;
+  for (int i=0; i<MAX_TIMERS; i++) timersStates[i].val = 500+i;
+  for (int i=0; i<MAX_SENSORS; i++) {
+    telemetryItems[i].value = 600+i;
+    telemetryItems[i].valueMin = 700+i;
+    telemetryItems[i].valueMax = 800+i;
+  }
+  g_model.logicalSw[0].func = LS_FUNC_VPOS;
+  g_model.logicalSw[0].v1 = MIXSRC_MAX;
+  evalLogicalSwitches();
+
+  for (int i=0; i<=MIXSRC_LAST_TELEM+1; i++) {
+    EXPECT_EQ(getValueChain(i), getValue(i)) << "source " << i;
+  }
+
+#if defined(LUA_MODEL_SCRIPTS)
+  for (int i=0; i<MAX_SCRIPTS*MAX_SCRIPT_OUTPUTS; i++) SCRIPT_OUTPUT_VALUE(i/MAX_SCRIPT_OUTPUTS, i%MAX_SCRIPT_OUTPUTS) = 0;
+#endif
+
+  TELEMETRY_RESET();
+  MODEL_RESET();
+  MIXER_RESET();
+}
+#endif
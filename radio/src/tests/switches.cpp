@@ -100,6 +100,93 @@ TEST(getSwitch, nullSW)
   EXPECT_EQ(getSwitch(0), true);
 }
 
+#if defined(PCBTARANIS)
+TEST(getSwitch, cachedDuringMixerCycle)
+{
+  RADIO_RESET();
+  MODEL_RESET();
+  MIXER_RESET();
+
+  simuSetSwitch(0, -1);
+  switchesCacheStart();
+  EXPECT_EQ(getSwitch(SWSRC_SA0), true);
+
+  // the position read in this cycle is kept
+  simuSetSwitch(0, 0);
+  EXPECT_EQ(getSwitch(SWSRC_SA0), true);
+  EXPECT_EQ(getSwitch(-SWSRC_SA0), false);
+  EXPECT_EQ(getSwitch(SWSRC_SA1), true);
+  switchesCacheStop();
+
+  // outside of the mixer cycle the switches are read directly
+  EXPECT_EQ(getSwitch(SWSRC_SA0), false);
+
+  switchesCacheStart();
+  EXPECT_EQ(getSwitch(SWSRC_SA0), false);
+  switchesCacheStop();
+
+  // after the generation counter wraps
+  simuSetSwitch(0, -1);
+  for (int i=0; i<0x7E; i++) {
+    switchesCacheStart();
+    switchesCacheStop();
+  }
+  switchesCacheStart();
+  EXPECT_EQ(getSwitch(SWSRC_SA0), true);
+  switchesCacheStop();
+  simuSetSwitch(0, 0);
+}
+
+TEST(evalLogicalSwitches, onlyChangedInputs)
+{
+  RADIO_RESET();
+  MODEL_RESET();
+  MIXER_RESET();
+  g_model.logicalSw[0] = { LS_FUNC_AND, SWSRC_SW3, 0 }; // reads a logical switch placed after it
+  g_model.logicalSw[1] = { LS_FUNC_VPOS, MIXSRC_Rud, 0 };
+  g_model.logicalSw[2] = { LS_FUNC_AND, SWSRC_SW2, SWSRC_SA0 };
+
+  simuSetSwitch(0, -1);
+  evalFlightModeMixes(e_perout_mode_normal, 1);
+  EXPECT_EQ(getSwitch(SWSRC_SW1), false);
+  EXPECT_EQ(getSwitch(SWSRC_SW2), false);
+  EXPECT_EQ(getSwitch(SWSRC_SW3), false);
+
+  // L3 follows L2 in the same tick, L1 on next tick
+  anaInValues[RUD_STICK] = 1024;
+  evalFlightModeMixes(e_perout_mode_normal, 1);
+  EXPECT_EQ(getSwitch(SWSRC_SW1), false);
+  EXPECT_EQ(getSwitch(SWSRC_SW2), true);
+  EXPECT_EQ(getSwitch(SWSRC_SW3), true);
+  evalFlightModeMixes(e_perout_mode_normal, 1);
+  EXPECT_EQ(getSwitch(SWSRC_SW1), true);
+
+  // the inputs didn't change but the model did
+  g_model.logicalSw[1].func = LS_FUNC_VNEG;
+  INVALIDATE_MIXER_PROGRAM();
+  evalFlightModeMixes(e_perout_mode_normal, 1);
+  EXPECT_EQ(getSwitch(SWSRC_SW1), true);
+  EXPECT_EQ(getSwitch(SWSRC_SW2), false);
+  EXPECT_EQ(getSwitch(SWSRC_SW3), false);
+  evalFlightModeMixes(e_perout_mode_normal, 1);
+  EXPECT_EQ(getSwitch(SWSRC_SW1), false);
+
+  g_model.logicalSw[1].func = LS_FUNC_VPOS;
+  INVALIDATE_MIXER_PROGRAM();
+  evalFlightModeMixes(e_perout_mode_normal, 1);
+  evalFlightModeMixes(e_perout_mode_normal, 1);
+  EXPECT_EQ(getSwitch(SWSRC_SW1), true);
+
+  simuSetSwitch(0, 0);
+  evalFlightModeMixes(e_perout_mode_normal, 1);
+  EXPECT_EQ(getSwitch(SWSRC_SW1), true);
+  EXPECT_EQ(getSwitch(SWSRC_SW2), true);
+  EXPECT_EQ(getSwitch(SWSRC_SW3), false);
+  evalFlightModeMixes(e_perout_mode_normal, 1);
+  EXPECT_EQ(getSwitch(SWSRC_SW1), false);
+}
+#endif
+
 #if 0
 TEST(getSwitch, DISABLED_VfasWithDelay)
 {
@@ -55,7 +55,7 @@ Defines the lowest priority that be assigned.
 /*!< 
 Max number of tasks that can be running.		     
 */			
-#define CFG_MAX_USER_TASKS      (5)
+#define CFG_MAX_USER_TASKS      (7)
 
 /*!< 
 Idle task stack size(word).		                         
@@ -157,6 +157,15 @@ Enable(1) or disable(0) stack overflow checkout .
 */		
 #define CFG_STK_CHECKOUT_EN     (0)		
 
+/*!< 
+Enable(1) or disable(0) the task switch hook (runtime of the tasks).
+*/
+#if defined(TASKS_PROFILE)
+#define CFG_TASK_SWITCH_HOOK_EN (1)
+#else
+#define CFG_TASK_SWITCH_HOOK_EN (0)
+#endif
+
 
 
 /*---------------------- Memory Management Config ----------------------------*/
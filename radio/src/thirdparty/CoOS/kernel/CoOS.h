@@ -241,5 +241,10 @@ extern void        CoTickToTime(U32 ticks,U8* hour,U8* minute,U8* sec,U16* mills
 extern void        CoIdleTask(void* pdata);
 extern void        CoStkOverflowHook(OS_TID taskID);
 
+/* Implement by the application */
+#if CFG_TASK_SWITCH_HOOK_EN > 0
+extern void        CoTaskSwitchHook(OS_TID from, OS_TID to);
+#endif
+
 
 #endif
@@ -790,6 +790,10 @@ void Schedule(void)
         CoStkOverflowHook(pCurTcb->taskID);       /* Yes,call handler         */		
     }   
 #endif
+
+#if CFG_TASK_SWITCH_HOOK_EN > 0
+    CoTaskSwitchHook(pCurTcb->taskID, TCBNext->taskID);
+#endif
  	
     SwitchContext();                              /* Call task context switch */
 }
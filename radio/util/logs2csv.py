@@ -0,0 +1,155 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+# This program converts the binary logs (.tlg, BINARY_LOGS=YES) to the CSV logs the radio writes otherwise
+#
+#   logs2csv.py input.tlg [output.csv]
+
+from __future__ import print_function
+
+import sys
+
+
+MAGIC = b"OTXL"
+VERSION = 1
+RECORD = 0x52  # 'R'
+
+COLUMN_VALUE = 0
+COLUMN_DATE = 1
+COLUMN_TIME = 2
+COLUMN_GPS = 3
+COLUMN_DATETIME = 4
+
+
+class Column:
+    def __init__(self, format, prec, name, unit):
+        self.format = format
+        self.prec = prec
+        self.name = name
+        self.unit = unit
+
+    def values(self):
+        return 2 if self.format in (COLUMN_GPS, COLUMN_DATETIME) else 1
+
+    def title(self):
+        if self.unit:
+            return "%s(%s)" % (self.name, self.unit)
+        else:
+            return self.name
+
+    def format_values(self, values, rtc):
+        if self.format == COLUMN_DATE:
+            return "%4d-%02d-%02d" % (values[0] // 10000, values[0] // 100 % 100, values[0] % 100)
+        elif self.format == COLUMN_TIME:
+            if not rtc:
+                return "%d" % values[0]
+            seconds, ms10 = divmod(values[0], 100)
+            return "%02d:%02d:%02d.%02d0" % (seconds // 3600, seconds // 60 % 60, seconds % 60, ms10)
+        elif self.format == COLUMN_GPS:
+            if not values[0] or not values[1]:
+                return ""
+            return "%s %s" % (gps(values[0], "E", "W"), gps(values[1], "N", "S"))
+        elif self.format == COLUMN_DATETIME:
+            if not values[0]:
+                return ""
+            date, time = values
+            return "%4d-%02d-%02d %02d:%02d:%02d" % (date // 10000, date // 100 % 100, date % 100, time // 10000, time // 100 % 100, time % 100)
+        elif self.prec == 2:
+            return "%s%d.%02d" % ("-" if values[0] < 0 else "", abs(values[0]) // 100, abs(values[0]) % 100)
+        elif self.prec == 1:
+            return "%s%d.%d" % ("-" if values[0] < 0 else "", abs(values[0]) // 10, abs(values[0]) % 10)
+        else:
+            return "%d" % values[0]
+
+
+def gps(value, positive, negative):
+    direction = negative if value < 0 else positive
+    value = abs(value) - 1
+    return "%03d.%04d%s" % (value // 10000, value % 10000, direction)
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = bytearray(data)
+        self.offset = 0
+
+    def eof(self):
+        return self.offset >= len(self.data)
+
+    def byte(self):
+        if self.eof():
+            raise EOFError()
+        result = self.data[self.offset]
+        self.offset += 1
+        return result
+
+    def string(self):
+        end = self.data.index(b"\0", self.offset)
+        result = self.data[self.offset:end].decode("latin-1")
+        self.offset = end + 1
+        return result
+
+    def varint(self):
+        result, shift = 0, 0
+        while True:
+            byte = self.byte()
+            result |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                return result
+
+    def header(self):
+        if self.data[self.offset:self.offset+len(MAGIC)] != MAGIC:
+            raise ValueError("no header at offset %d" % self.offset)
+        self.offset += len(MAGIC)
+        version = self.byte()
+        if version != VERSION:
+            raise ValueError("unsupported version %d" % version)
+        columns = []
+        for i in range(self.byte()):
+            format, prec = self.byte(), self.byte()
+            columns.append(Column(format, prec, self.string(), self.string()))
+        return columns
+
+
+def convert(data, output):
+    reader = Reader(data)
+    columns, previous, titles = None, None, None
+    while not reader.eof():
+        if reader.data[reader.offset] != RECORD:
+            columns = reader.header()
+            previous = [0] * sum(column.values() for column in columns)
+            rtc = any(column.format == COLUMN_DATE for column in columns)
+            if titles != [column.title() for column in columns]:
+                titles = [column.title() for column in columns]
+                output.write(",".join(titles) + "\n")
+            continue
+        start = reader.offset
+        try:
+            reader.byte()
+            for i in range(len(previous)):
+                zigzag = reader.varint()
+                delta = (zigzag >> 1) ^ -(zigzag & 1)
+                value = (previous[i] + delta) & 0xFFFFFFFF
+                previous[i] = value - 0x100000000 if value & 0x80000000 else value
+        except EOFError:
+            print("truncated record at offset %d" % start, file=sys.stderr)
+            break
+        fields, index = [], 0
+        for column in columns:
+            fields.append(column.format_values(previous[index:index+column.values()], rtc))
+            index += column.values()
+        output.write(",".join(fields) + "\n")
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print("Usage: %s input.tlg [output.csv]" % sys.argv[0], file=sys.stderr)
+        sys.exit(1)
+    with open(sys.argv[1], "rb") as f:
+        data = f.read()
+    if len(sys.argv) > 2:
+        with open(sys.argv[2], "w") as output:
+            convert(data, output)
+    else:
+        convert(data, sys.stdout)